@@ -0,0 +1,25 @@
+#ifndef ECSACT_SI_WASMER_CALL_MEM_H
+#define ECSACT_SI_WASMER_CALL_MEM_H
+
+#include <stdint.h>
+#include "ecsact/si/wasm.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Most call memory (in bytes) a single impl call of @p system_id has used
+ * since the last `ecsact_si_wasm_load`. Call memory holds the execution
+ * context handles given to the guest. Should not be called while systems are
+ * executing.
+ */
+ECSACT_SI_WASM_API int32_t ecsact_si_wasmer_call_mem_high_water_mark( //
+	ecsact_system_like_id system_id
+);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ECSACT_SI_WASMER_CALL_MEM_H
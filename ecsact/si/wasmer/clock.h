@@ -0,0 +1,47 @@
+#ifndef ECSACT_SI_WASMER_CLOCK_H
+#define ECSACT_SI_WASMER_CLOCK_H
+
+#include <stdint.h>
+#include "ecsact/si/wasm.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Makes the WASI clocks and `random_get` deterministic, for lockstep
+ * simulations that must produce the same results everywhere.
+ *
+ * All clocks start at 0 and only move when
+ * `ecsact_si_wasmer_advance_deterministic_clock` is called, by
+ * @p tick_duration_ns per tick. Random bytes come from a generator seeded
+ * with @p seed and keyed on the current tick and the system and entity being
+ * executed. The same seed, tick, system and entity always give the same
+ * bytes, no matter which instance or thread runs the system.
+ *
+ * Must not be called while systems are executing.
+ */
+ECSACT_SI_WASM_API void ecsact_si_wasmer_enable_deterministic_mode(
+	int64_t  tick_duration_ns,
+	uint64_t seed
+);
+
+/**
+ * Goes back to the real clocks and OS randomness (default)
+ */
+ECSACT_SI_WASM_API void ecsact_si_wasmer_disable_deterministic_mode(void);
+
+/**
+ * Moves the deterministic clock forward by @p ticks. Usually called once per
+ * simulation step, between executions. The clock never goes back, negative
+ * @p ticks are ignored. Clocks stop at the largest time they can report.
+ */
+ECSACT_SI_WASM_API void ecsact_si_wasmer_advance_deterministic_clock(
+	int64_t ticks
+);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ECSACT_SI_WASMER_CLOCK_H
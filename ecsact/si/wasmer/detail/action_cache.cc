@@ -0,0 +1,16 @@
+#include "ecsact/si/wasmer/detail/action_cache.hh"
+
+#include "ecsact/runtime/dynamic.h"
+#include "ecsact/si/wasmer/detail/instance_env.hh"
+
+auto ecsact::wasm::detail::populate_action_cache(
+	instance_env&                    env,
+	const action_cache&              cache,
+	ecsact_system_execution_context* ctx
+) -> void {
+	auto action_data = env.registered_region(cache.guest_ptr, cache.size);
+
+	// The runtime copies straight into guest memory. No guest transition or
+	// intermediate host buffer is involved.
+	ecsact_system_execution_context_action(ctx, action_data);
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "ecsact/runtime/common.h"
+
+namespace ecsact::wasm::detail {
+
+struct instance_env;
+
+/**
+ * Guest memory buffer registered by the guest (see
+ * `ecsact_si_wasm_register_action_cache`) that the host copies the action
+ * payload into before every call of the action's system impl, i.e. once per
+ * entity. Guests read the action from the buffer instead of calling
+ * `ecsact_system_execution_context_action`, which saves the guest to host
+ * transition and the intermediate buffer but not the copy itself.
+ */
+struct action_cache {
+	std::int32_t guest_ptr = 0;
+	std::size_t  size = 0;
+};
+
+/**
+ * Copies the action of @p ctx into @p cache. Always copies, even when @p ctx
+ * is the context of the previous call: runtimes may reuse a context's address
+ * for the next action of the same type and the dynamic API has no way to tell
+ * executions apart, so skipping the copy could hand the guest a stale action.
+ */
+auto populate_action_cache(
+	instance_env&                    env,
+	const action_cache&              cache,
+	ecsact_system_execution_context* ctx
+) -> void;
+
+} // namespace ecsact::wasm::detail
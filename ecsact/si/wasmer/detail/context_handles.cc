@@ -0,0 +1,67 @@
+#include "ecsact/si/wasmer/detail/context_handles.hh"
+
+#include <cassert>
+#include <vector>
+#include "ecsact/si/wasmer/detail/mem_stack.hh"
+
+using ecsact::wasm::detail::call_mem_alloc;
+using ecsact::wasm::detail::call_mem_invalid_offset;
+using ecsact::wasm::detail::context_handles;
+
+auto context_handles::reset() -> void {
+	_handles.clear();
+	_others.clear();
+
+	// Offset 0 is reserved so a null guest context never refers to a real one
+	[[maybe_unused]] auto null_handle =
+		call_mem_alloc<ecsact_system_execution_context*>(nullptr);
+	assert(null_handle == 0);
+}
+
+auto context_handles::truncate(std::int32_t offset) -> void {
+	std::erase_if(_handles, [&](auto& entry) { return entry.handle >= offset; });
+	std::erase_if(_others, [&](auto& entry) { return entry.handle >= offset; });
+}
+
+auto context_handles::get( //
+	const ecsact_system_execution_context* ctx
+) -> std::int32_t {
+	if(ctx == nullptr) {
+		return 0;
+	}
+
+	for(auto& entry : _handles) {
+		if(entry.ctx == ctx) {
+			return entry.handle;
+		}
+	}
+
+	auto handle = call_mem_alloc( //
+		const_cast<ecsact_system_execution_context*>(ctx)
+	);
+	if(handle != call_mem_invalid_offset) {
+		_handles.push_back({ctx, handle});
+	}
+	return handle;
+}
+
+auto context_handles::find_other(
+	const ecsact_system_execution_context* ctx,
+	ecsact_system_assoc_id                 assoc_id
+) const -> std::optional<std::int32_t> {
+	for(auto& entry : _others) {
+		if(entry.ctx == ctx && entry.assoc_id == assoc_id) {
+			return entry.handle;
+		}
+	}
+
+	return std::nullopt;
+}
+
+auto context_handles::cache_other(
+	const ecsact_system_execution_context* ctx,
+	ecsact_system_assoc_id                 assoc_id,
+	std::int32_t                           other_handle
+) -> void {
+	_others.push_back({ctx, assoc_id, other_handle});
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+#include "ecsact/runtime/common.h"
+
+namespace ecsact::wasm::detail {
+
+/**
+ * Guest handles (call memory offsets) of the execution contexts handed to the
+ * guest during a single system impl call. The same context always gets the
+ * same handle and `other` lookups are memoized, so call memory usage doesn't
+ * grow no matter how often the guest walks its parents or associations.
+ */
+class context_handles {
+public:
+	/**
+	 * Forgets all handles. Must be called right after call memory is set for a
+	 * new system impl call.
+	 */
+	auto reset() -> void;
+
+	/**
+	 * Forgets the handles allocated at or after @p offset. Called when the call
+	 * memory frame they were allocated in is popped.
+	 */
+	auto truncate(std::int32_t offset) -> void;
+
+	/**
+	 * Gets the handle of @p ctx, allocating it in call memory the first time
+	 * @p ctx is seen. A null @p ctx is always handle `0`. Returns
+	 * `call_mem_invalid_offset` if call memory is exhausted.
+	 */
+	auto get(const ecsact_system_execution_context* ctx) -> std::int32_t;
+
+	auto find_other(
+		const ecsact_system_execution_context* ctx,
+		ecsact_system_assoc_id                 assoc_id
+	) const -> std::optional<std::int32_t>;
+
+	auto cache_other(
+		const ecsact_system_execution_context* ctx,
+		ecsact_system_assoc_id                 assoc_id,
+		std::int32_t                           other_handle
+	) -> void;
+
+private:
+	struct context_handle {
+		const ecsact_system_execution_context* ctx;
+		std::int32_t                           handle;
+	};
+
+	struct other_handle {
+		const ecsact_system_execution_context* ctx;
+		ecsact_system_assoc_id                 assoc_id;
+		std::int32_t                           handle;
+	};
+
+	// A system impl only ever sees a handful of contexts so a linear search
+	// beats hashing. Cleared (not freed) between calls.
+	std::vector<context_handle> _handles;
+	std::vector<other_handle>   _others;
+};
+
+} // namespace ecsact::wasm::detail
@@ -0,0 +1,172 @@
+#include "ecsact/si/wasmer/detail/file_writer.hh"
+
+#include <algorithm>
+#include <filesystem>
+
+using ecsact::wasm::detail::file_writer;
+
+namespace {
+/**
+ * Pending bytes of one file on one thread that wake the flush thread early
+ */
+constexpr auto eager_flush_size = std::size_t{64 * 1024};
+
+/**
+ * Pending bytes of one thread after which its writes are dropped
+ */
+constexpr auto max_pending_size = std::size_t{64 * 1024 * 1024};
+
+constexpr auto default_flush_interval = std::chrono::milliseconds{100};
+} // namespace
+
+file_writer::file_writer(std::chrono::milliseconds flush_interval)
+	: _flush_interval(flush_interval) {
+	// Started last so every member is initialized before the thread runs
+	_thread = std::jthread{[this](std::stop_token stop) { run(stop); }};
+}
+
+file_writer::~file_writer() {
+	_thread.request_stop();
+	_thread.join();
+	flush();
+
+	for(auto file : _files) {
+		std::fclose(file);
+	}
+}
+
+auto file_writer::open(const std::string& real_path) -> std::int32_t {
+	// Different spellings of the same path must share one FILE* or the second
+	// open would truncate what the first one wrote
+	auto ec = std::error_code{};
+	auto key = std::filesystem::weakly_canonical(real_path, ec).string();
+	if(ec) {
+		return -1;
+	}
+
+	auto lk = std::scoped_lock{_files_mutex};
+	if(auto itr = _file_ids.find(key); itr != _file_ids.end()) {
+		return itr->second;
+	}
+
+	auto file = std::fopen(real_path.c_str(), "wb");
+	if(!file) {
+		return -1;
+	}
+
+	auto file_id = static_cast<std::int32_t>(_files.size());
+	_files.push_back(file);
+	_file_ids.emplace(std::move(key), file_id);
+	return file_id;
+}
+
+auto file_writer::current_thread_buffer() -> thread_buffer& {
+	// There is only ever one writer (`output_file_writer`) so one buffer per
+	// thread is enough
+	static thread_local auto buffer = [this] {
+		auto buffer = std::make_shared<thread_buffer>();
+		auto lk = std::scoped_lock{_buffers_mutex};
+		_buffers.push_back(buffer);
+		return buffer;
+	}();
+
+	return *buffer;
+}
+
+auto file_writer::append(
+	std::int32_t               file_id,
+	std::span<const std::byte> data
+) -> bool {
+	auto& buffer = current_thread_buffer();
+	auto  pending_size = std::size_t{};
+	{
+		auto lk = std::scoped_lock{buffer.mutex};
+		if(data.size() > max_pending_size - buffer.pending_size) {
+			_dropped_bytes.fetch_add(data.size(), std::memory_order_relaxed);
+			return false;
+		}
+
+		auto& pending = buffer.pending[file_id];
+		pending.insert(pending.end(), data.begin(), data.end());
+		buffer.pending_size += data.size();
+		pending_size = pending.size();
+	}
+
+	if(pending_size >= eager_flush_size) {
+		notify();
+	}
+
+	return true;
+}
+
+auto file_writer::dropped_bytes() const -> std::uint64_t {
+	return _dropped_bytes.load(std::memory_order_relaxed);
+}
+
+auto file_writer::notify() -> void {
+	{
+		std::scoped_lock lk(_mutex);
+		_notified = true;
+	}
+	_cv.notify_one();
+}
+
+auto file_writer::run(std::stop_token stop) -> void {
+	while(!stop.stop_requested()) {
+		{
+			auto lk = std::unique_lock{_mutex};
+			_cv.wait_for(lk, stop, _flush_interval, [this] { return _notified; });
+			_notified = false;
+		}
+
+		flush();
+	}
+}
+
+auto file_writer::flush() -> void {
+	auto flush_lk = std::scoped_lock{_flush_mutex};
+
+	auto buffers = std::vector<std::shared_ptr<thread_buffer>>{};
+	{
+		auto lk = std::scoped_lock{_buffers_mutex};
+		buffers = _buffers;
+	}
+
+	auto taken = std::unordered_map<std::int32_t, std::vector<std::byte>>{};
+	for(auto& buffer : buffers) {
+		{
+			auto lk = std::scoped_lock{buffer->mutex};
+			taken.swap(buffer->pending);
+			buffer->pending_size = 0;
+		}
+
+		for(auto& [file_id, bytes] : taken) {
+			auto file = [&] {
+				auto lk = std::scoped_lock{_files_mutex};
+				return _files.at(file_id);
+			}();
+			std::fwrite(bytes.data(), 1, bytes.size(), file);
+		}
+		taken.clear();
+	}
+
+	{
+		auto lk = std::scoped_lock{_files_mutex};
+		for(auto file : _files) {
+			std::fflush(file);
+		}
+	}
+
+	// Buffers of threads that exited are only referenced by `_buffers`
+	buffers.clear();
+	auto buffers_lk = std::scoped_lock{_buffers_mutex};
+	std::erase_if(_buffers, [](auto& buffer) {
+		auto lk = std::scoped_lock{buffer->mutex};
+		return buffer.use_count() == 1 && buffer->pending.empty();
+	});
+}
+
+auto ecsact::wasm::detail::output_file_writer() -> file_writer& {
+	static auto writer = file_writer{default_flush_interval};
+	return writer;
+}
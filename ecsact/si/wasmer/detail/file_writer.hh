@@ -0,0 +1,100 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <stop_token>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace ecsact::wasm::detail {
+
+/**
+ * Writes guest output files from a dedicated thread. Writers only append to
+ * a buffer owned by their thread. Its lock is shared with `flush`, which
+ * holds it just long enough to swap the buffer out, so guests never wait on
+ * the disk but may briefly wait on a flush. Every `flush_interval` (or once a
+ * buffer grows large) the thread swaps the buffers out and writes them in one
+ * go per file.
+ *
+ * Writes from one thread reach the file in order. Writes from different
+ * threads are not interleaved but their order is unspecified. A thread whose
+ * buffer is full (the disk can't keep up) drops its writes and only counts
+ * them.
+ */
+class file_writer {
+public:
+	file_writer(std::chrono::milliseconds flush_interval);
+
+	file_writer(const file_writer&) = delete;
+	~file_writer();
+
+	/**
+	 * Creates (or truncates) @p real_path for writing. Opening a file that is
+	 * already open returns its id without truncating it again.
+	 *
+	 * @returns id for `append` or -1 if the file could not be opened
+	 */
+	auto open(const std::string& real_path) -> std::int32_t;
+
+	/**
+	 * @returns `false` if @p data was dropped because the buffer of the calling
+	 *          thread is full
+	 */
+	auto append(std::int32_t file_id, std::span<const std::byte> data) -> bool;
+
+	/**
+	 * Total bytes dropped by `append` because of a full buffer
+	 */
+	auto dropped_bytes() const -> std::uint64_t;
+
+	/**
+	 * Writes everything appended so far before returning
+	 */
+	auto flush() -> void;
+
+private:
+	/**
+	 * Pending bytes per file of one thread
+	 */
+	struct thread_buffer {
+		std::mutex                                               mutex;
+		std::unordered_map<std::int32_t, std::vector<std::byte>> pending;
+		std::size_t                                              pending_size = 0;
+	};
+
+	std::chrono::milliseconds _flush_interval;
+	std::atomic_uint64_t      _dropped_bytes = 0;
+
+	std::mutex                                    _files_mutex;
+	std::vector<std::FILE*>                       _files;
+	std::unordered_map<std::string, std::int32_t> _file_ids;
+
+	std::mutex                                  _buffers_mutex;
+	std::vector<std::shared_ptr<thread_buffer>> _buffers;
+
+	std::mutex                  _flush_mutex;
+	std::mutex                  _mutex;
+	std::condition_variable_any _cv;
+	bool                        _notified = false;
+	std::jthread                _thread;
+
+	auto current_thread_buffer() -> thread_buffer&;
+	auto notify() -> void;
+	auto run(std::stop_token stop) -> void;
+};
+
+/**
+ * The writer used for every guest output file, created on first use
+ */
+auto output_file_writer() -> file_writer&;
+
+} // namespace ecsact::wasm::detail
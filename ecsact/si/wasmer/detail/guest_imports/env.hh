@@ -9,7 +9,7 @@ namespace ecsact::wasm::detail {
 const auto guest_env_module_imports = allowed_guest_imports_t{
 	{
 		"ecsact_system_execution_context_action",
-		[]() -> minst_import_resolve_func {
+		[]() -> minst_import_resolve_func_with_env {
 			return {
 				wasm_functype_new_2_0(
 					wasm_valtype_new(WASM_I32), // context
@@ -21,7 +21,7 @@ const auto guest_env_module_imports = allowed_guest_imports_t{
 	},
 	{
 		"ecsact_system_execution_context_parent",
-		[]() -> minst_import_resolve_func {
+		[]() -> minst_import_resolve_func_with_env {
 			return {
 				wasm_functype_new_1_1(
 					wasm_valtype_new(WASM_I32), // context
@@ -33,7 +33,7 @@ const auto guest_env_module_imports = allowed_guest_imports_t{
 	},
 	{
 		"ecsact_system_execution_context_same",
-		[]() -> minst_import_resolve_func {
+		[]() -> minst_import_resolve_func_with_env {
 			return {
 				wasm_functype_new_2_1(
 					wasm_valtype_new(WASM_I32), // context a
@@ -46,7 +46,7 @@ const auto guest_env_module_imports = allowed_guest_imports_t{
 	},
 	{
 		"ecsact_system_execution_context_get",
-		[]() -> minst_import_resolve_func {
+		[]() -> minst_import_resolve_func_with_env {
 			return {
 				wasm_functype_new_4_0(
 					wasm_valtype_new(WASM_I32), // context
@@ -60,7 +60,7 @@ const auto guest_env_module_imports = allowed_guest_imports_t{
 	},
 	{
 		"ecsact_system_execution_context_update",
-		[]() -> minst_import_resolve_func {
+		[]() -> minst_import_resolve_func_with_env {
 			return {
 				wasm_functype_new_4_0(
 					wasm_valtype_new(WASM_I32), // context
@@ -74,7 +74,7 @@ const auto guest_env_module_imports = allowed_guest_imports_t{
 	},
 	{
 		"ecsact_system_execution_context_has",
-		[]() -> minst_import_resolve_func {
+		[]() -> minst_import_resolve_func_with_env {
 			return {
 				wasm_functype_new_3_0(
 					wasm_valtype_new(WASM_I32), // context
@@ -85,9 +85,54 @@ const auto guest_env_module_imports = allowed_guest_imports_t{
 			};
 		},
 	},
+	{
+		"ecsact_system_execution_context_get_many",
+		[]() -> minst_import_resolve_func_with_env {
+			return {
+				wasm_functype_new_5_0(
+					wasm_valtype_new(WASM_I32), // context
+					wasm_valtype_new(WASM_I32), // components_count
+					wasm_valtype_new(WASM_I32), // component_ids
+					wasm_valtype_new(WASM_I32), // out_components_data
+					wasm_valtype_new(WASM_I32) // indexed_fields (nullable)
+				),
+				&wasm_ecsact_system_execution_context_get_many,
+			};
+		},
+	},
+	{
+		"ecsact_system_execution_context_update_many",
+		[]() -> minst_import_resolve_func_with_env {
+			return {
+				wasm_functype_new_5_0(
+					wasm_valtype_new(WASM_I32), // context
+					wasm_valtype_new(WASM_I32), // components_count
+					wasm_valtype_new(WASM_I32), // component_ids
+					wasm_valtype_new(WASM_I32), // components_data
+					wasm_valtype_new(WASM_I32) // indexed_fields (nullable)
+				),
+				&wasm_ecsact_system_execution_context_update_many,
+			};
+		},
+	},
+	{
+		"ecsact_system_execution_context_has_many",
+		[]() -> minst_import_resolve_func_with_env {
+			return {
+				wasm_functype_new_5_0(
+					wasm_valtype_new(WASM_I32), // context
+					wasm_valtype_new(WASM_I32), // components_count
+					wasm_valtype_new(WASM_I32), // component_ids
+					wasm_valtype_new(WASM_I32), // indexed_fields (nullable)
+					wasm_valtype_new(WASM_I32) // out_has
+				),
+				&wasm_ecsact_system_execution_context_has_many,
+			};
+		},
+	},
 	{
 		"ecsact_system_execution_context_generate",
-		[]() -> minst_import_resolve_func {
+		[]() -> minst_import_resolve_func_with_env {
 			return {
 				wasm_functype_new_4_0(
 					wasm_valtype_new(WASM_I32), // context
@@ -99,9 +144,24 @@ const auto guest_env_module_imports = allowed_guest_imports_t{
 			};
 		},
 	},
+	{
+		"ecsact_system_execution_context_generate_many",
+		[]() -> minst_import_resolve_func_with_env {
+			return {
+				wasm_functype_new_5_0(
+					wasm_valtype_new(WASM_I32), // context
+					wasm_valtype_new(WASM_I32), // entities_count
+					wasm_valtype_new(WASM_I32), // components_counts
+					wasm_valtype_new(WASM_I32), // component_ids
+					wasm_valtype_new(WASM_I32) // components_data
+				),
+				&wasm_ecsact_system_execution_context_generate_many,
+			};
+		},
+	},
 	{
 		"ecsact_system_execution_context_add",
-		[]() -> minst_import_resolve_func {
+		[]() -> minst_import_resolve_func_with_env {
 			return {
 				wasm_functype_new_3_0(
 					wasm_valtype_new(WASM_I32), // context
@@ -114,7 +174,7 @@ const auto guest_env_module_imports = allowed_guest_imports_t{
 	},
 	{
 		"ecsact_system_execution_context_remove",
-		[]() -> minst_import_resolve_func {
+		[]() -> minst_import_resolve_func_with_env {
 			return {
 				wasm_functype_new_3_0(
 					wasm_valtype_new(WASM_I32), // context
@@ -127,7 +187,7 @@ const auto guest_env_module_imports = allowed_guest_imports_t{
 	},
 	{
 		"ecsact_system_execution_context_other",
-		[]() -> minst_import_resolve_func {
+		[]() -> minst_import_resolve_func_with_env {
 			return {
 				wasm_functype_new_2_1(
 					wasm_valtype_new(WASM_I32), // context
@@ -140,7 +200,7 @@ const auto guest_env_module_imports = allowed_guest_imports_t{
 	},
 	{
 		"ecsact_system_execution_context_entity",
-		[]() -> minst_import_resolve_func {
+		[]() -> minst_import_resolve_func_with_env {
 			return {
 				wasm_functype_new_1_1(
 					wasm_valtype_new(WASM_I32), // context
@@ -152,7 +212,7 @@ const auto guest_env_module_imports = allowed_guest_imports_t{
 	},
 	{
 		"ecsact_system_execution_context_stream_toggle",
-		[]() -> minst_import_resolve_func {
+		[]() -> minst_import_resolve_func_with_env {
 			return {
 				wasm_functype_new_4_0(
 					wasm_valtype_new(WASM_I32), // context
@@ -164,6 +224,67 @@ const auto guest_env_module_imports = allowed_guest_imports_t{
 			};
 		},
 	},
+	{
+		"ecsact_si_wasm_register_readonly_frame",
+		[]() -> minst_import_resolve_func_with_env {
+			return {
+				wasm_functype_new_6_0(
+					wasm_valtype_new(WASM_I32), // system_id
+					wasm_valtype_new(WASM_I32), // frame
+					wasm_valtype_new(WASM_I32), // components_count
+					wasm_valtype_new(WASM_I32), // component_ids
+					wasm_valtype_new(WASM_I32), // component_offsets
+					wasm_valtype_new(WASM_I32) // component_sizes
+				),
+				&wasm_ecsact_si_wasm_register_readonly_frame,
+			};
+		},
+	},
+	{
+		"ecsact_si_wasm_register_action_cache",
+		[]() -> minst_import_resolve_func_with_env {
+			return {
+				wasm_functype_new_3_0(
+					wasm_valtype_new(WASM_I32), // action_id
+					wasm_valtype_new(WASM_I32), // action_buffer
+					wasm_valtype_new(WASM_I32) // action_buffer_size
+				),
+				&wasm_ecsact_si_wasm_register_action_cache,
+			};
+		},
+	},
+	{
+		"ecsact_si_wasm_register_presence_mask",
+		[]() -> minst_import_resolve_func_with_env {
+			return {
+				wasm_functype_new_4_0(
+					wasm_valtype_new(WASM_I32), // system_id
+					wasm_valtype_new(WASM_I32), // mask
+					wasm_valtype_new(WASM_I32), // components_count
+					wasm_valtype_new(WASM_I32) // component_ids
+				),
+				&wasm_ecsact_si_wasm_register_presence_mask,
+			};
+		},
+	},
+	{
+		"ecsact_si_wasm_call_mem_push_frame",
+		[]() -> minst_import_resolve_func_with_env {
+			return {
+				wasm_functype_new_0_1(wasm_valtype_new(WASM_I32)), // frame
+				&wasm_ecsact_si_wasm_call_mem_push_frame,
+			};
+		},
+	},
+	{
+		"ecsact_si_wasm_call_mem_pop_frame",
+		[]() -> minst_import_resolve_func_with_env {
+			return {
+				wasm_functype_new_1_0(wasm_valtype_new(WASM_I32)), // frame
+				&wasm_ecsact_si_wasm_call_mem_pop_frame,
+			};
+		},
+	},
 };
 
 } // namespace ecsact::wasm::detail
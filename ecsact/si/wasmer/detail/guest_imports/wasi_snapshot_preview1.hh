@@ -8,7 +8,7 @@ namespace ecsact::wasm::detail {
 const auto guest_wasi_module_imports = allowed_guest_imports_t{
 	{
 		"proc_exit",
-		[]() -> minst_import_resolve_func {
+		[]() -> minst_import_resolve_func_with_env {
 			return {
 				wasm_functype_new_1_0( //
 					wasm_valtype_new(WASM_I32) // exit_code
@@ -19,7 +19,7 @@ const auto guest_wasi_module_imports = allowed_guest_imports_t{
 	},
 	{
 		"fd_seek",
-		[]() -> minst_import_resolve_func {
+		[]() -> minst_import_resolve_func_with_env {
 			return {
 				wasm_functype_new_4_1(
 					wasm_valtype_new_i32(), // fd
@@ -32,9 +32,22 @@ const auto guest_wasi_module_imports = allowed_guest_imports_t{
 			};
 		},
 	},
+	{
+		"fd_tell",
+		[]() -> minst_import_resolve_func_with_env {
+			return {
+				wasm_functype_new_2_1(
+					wasm_valtype_new_i32(), // fd
+					wasm_valtype_new_i32(), // retptr0
+					wasm_valtype_new_i32() // error code (return)
+				),
+				&ecsact_si_wasi_fd_tell,
+			};
+		},
+	},
 	{
 		"fd_write",
-		[]() -> minst_import_resolve_func {
+		[]() -> minst_import_resolve_func_with_env {
 			return {
 				wasm_functype_new_4_1(
 					wasm_valtype_new_i32(), // fd
@@ -49,7 +62,7 @@ const auto guest_wasi_module_imports = allowed_guest_imports_t{
 	},
 	{
 		"fd_read",
-		[]() -> minst_import_resolve_func {
+		[]() -> minst_import_resolve_func_with_env {
 			return {
 				wasm_functype_new_4_1(
 					wasm_valtype_new_i32(), // fd
@@ -62,9 +75,25 @@ const auto guest_wasi_module_imports = allowed_guest_imports_t{
 			};
 		},
 	},
+	{
+		"fd_pread",
+		[]() -> minst_import_resolve_func_with_env {
+			return {
+				wasm_functype_new_5_1(
+					wasm_valtype_new_i32(), // fd
+					wasm_valtype_new_i32(), // iovs
+					wasm_valtype_new_i32(), // iovs_len
+					wasm_valtype_new_i64(), // offset
+					wasm_valtype_new_i32(), // retptr0
+					wasm_valtype_new_i32() // error code (return)
+				),
+				&ecsact_si_wasi_fd_pread,
+			};
+		},
+	},
 	{
 		"fd_close",
-		[]() -> minst_import_resolve_func {
+		[]() -> minst_import_resolve_func_with_env {
 			return {
 				wasm_functype_new_1_1(
 					wasm_valtype_new_i32(), // fd
@@ -76,7 +105,7 @@ const auto guest_wasi_module_imports = allowed_guest_imports_t{
 	},
 	{
 		"environ_sizes_get",
-		[]() -> minst_import_resolve_func {
+		[]() -> minst_import_resolve_func_with_env {
 			return {
 				wasm_functype_new_2_1(
 					wasm_valtype_new_i32(), // retptr0
@@ -89,7 +118,7 @@ const auto guest_wasi_module_imports = allowed_guest_imports_t{
 	},
 	{
 		"environ_get",
-		[]() -> minst_import_resolve_func {
+		[]() -> minst_import_resolve_func_with_env {
 			return {
 				wasm_functype_new_2_1(
 					wasm_valtype_new_i32(), // environ
@@ -102,7 +131,7 @@ const auto guest_wasi_module_imports = allowed_guest_imports_t{
 	},
 	{
 		"fd_fdstat_get",
-		[]() -> minst_import_resolve_func {
+		[]() -> minst_import_resolve_func_with_env {
 			return {
 				wasm_functype_new_2_1(
 					wasm_valtype_new_i32(), // fd
@@ -113,6 +142,122 @@ const auto guest_wasi_module_imports = allowed_guest_imports_t{
 			};
 		},
 	},
+	{
+		"fd_filestat_get",
+		[]() -> minst_import_resolve_func_with_env {
+			return {
+				wasm_functype_new_2_1(
+					wasm_valtype_new_i32(), // fd
+					wasm_valtype_new_i32(), // retptr0
+					wasm_valtype_new_i32() // error code (return)
+				),
+				&ecsact_si_wasi_fd_filestat_get,
+			};
+		},
+	},
+	{
+		"fd_prestat_get",
+		[]() -> minst_import_resolve_func_with_env {
+			return {
+				wasm_functype_new_2_1(
+					wasm_valtype_new_i32(), // fd
+					wasm_valtype_new_i32(), // retptr0
+					wasm_valtype_new_i32() // error code (return)
+				),
+				&ecsact_si_wasi_fd_prestat_get,
+			};
+		},
+	},
+	{
+		"fd_prestat_dir_name",
+		[]() -> minst_import_resolve_func_with_env {
+			return {
+				wasm_functype_new_3_1(
+					wasm_valtype_new_i32(), // fd
+					wasm_valtype_new_i32(), // path
+					wasm_valtype_new_i32(), // path_len
+					wasm_valtype_new_i32() // error code (return)
+				),
+				&ecsact_si_wasi_fd_prestat_dir_name,
+			};
+		},
+	},
+	{
+		"fd_readdir",
+		[]() -> minst_import_resolve_func_with_env {
+			return {
+				wasm_functype_new_5_1(
+					wasm_valtype_new_i32(), // fd
+					wasm_valtype_new_i32(), // buf
+					wasm_valtype_new_i32(), // buf_len
+					wasm_valtype_new_i64(), // cookie
+					wasm_valtype_new_i32(), // retptr0
+					wasm_valtype_new_i32() // error code (return)
+				),
+				&ecsact_si_wasi_fd_readdir,
+			};
+		},
+	},
+	{
+		"clock_res_get",
+		[]() -> minst_import_resolve_func_with_env {
+			return {
+				wasm_functype_new_2_1(
+					wasm_valtype_new_i32(), // id
+					wasm_valtype_new_i32(), // retptr0
+					wasm_valtype_new_i32() // error code (return)
+				),
+				&ecsact_si_wasi_clock_res_get,
+			};
+		},
+	},
+	{
+		"clock_time_get",
+		[]() -> minst_import_resolve_func_with_env {
+			return {
+				wasm_functype_new_3_1(
+					wasm_valtype_new_i32(), // id
+					wasm_valtype_new_i64(), // precision
+					wasm_valtype_new_i32(), // retptr0
+					wasm_valtype_new_i32() // error code (return)
+				),
+				&ecsact_si_wasi_clock_time_get,
+			};
+		},
+	},
+	{
+		"random_get",
+		[]() -> minst_import_resolve_func_with_env {
+			return {
+				wasm_functype_new_2_1(
+					wasm_valtype_new_i32(), // buf
+					wasm_valtype_new_i32(), // buf_len
+					wasm_valtype_new_i32() // error code (return)
+				),
+				&ecsact_si_wasi_random_get,
+			};
+		},
+	},
+	{
+		"path_open",
+		[]() -> minst_import_resolve_func_with_env {
+			return {
+				wasm_functype_new_9_1(
+					wasm_valtype_new_i32(), // fd
+					wasm_valtype_new_i32(), // dirflags
+					wasm_valtype_new_i32(), // path
+					wasm_valtype_new_i32(), // path_len
+					wasm_valtype_new_i32(), // oflags
+					wasm_valtype_new_i64(), // fs_rights_base
+					wasm_valtype_new_i64(), // fs_rights_inheriting
+					wasm_valtype_new_i32(), // fdflags
+					wasm_valtype_new_i32(), // retptr0
+					wasm_valtype_new_i32() // error code (return)
+				),
+				&ecsact_si_wasi_path_open,
+			};
+		},
+	},
 };
 
 } // namespace ecsact::wasm::detail
@@ -0,0 +1,95 @@
+#include "ecsact/si/wasmer/detail/instance_env.hh"
+
+#include <cassert>
+#include <string>
+#include "ecsact/si/wasmer/detail/schema.hh"
+
+using ecsact::wasm::detail::component_data_size;
+using ecsact::wasm::detail::instance_env;
+using ecsact::wasm::detail::wasi::env_vars::current_environment;
+using ecsact::wasm::detail::wasi::env_vars::environment_block;
+
+auto instance_env::sync_memory() -> void {
+	auto size = wasm_memory_data_size(memory);
+
+	// Growing the memory is the only way the data pointer may move
+	if(size != memory_data_size) {
+		memory_data = reinterpret_cast<std::byte*>(wasm_memory_data(memory));
+		memory_data_size = size;
+	}
+}
+
+auto instance_env::registered_region( //
+	std::int32_t guest_ptr,
+	std::size_t  size
+) -> std::byte* {
+	sync_memory();
+
+	// Bounds were checked at registration and guest memory never shrinks
+	auto region = guest_cast<std::byte>(guest_ptr, size);
+	assert(region != nullptr);
+	return region;
+}
+
+auto instance_env::trap(std::string_view message) const -> wasm_trap_t* {
+	auto message_str = std::string{message};
+	auto trap_message = wasm_message_t{};
+
+	// trap messages are expected to be null terminated
+	wasm_byte_vec_new(
+		&trap_message,
+		message_str.size() + 1,
+		message_str.c_str()
+	);
+	auto trap = wasm_trap_new(store, &trap_message);
+	wasm_byte_vec_delete(&trap_message);
+
+	return trap;
+}
+
+auto instance_env::out_of_bounds_trap( //
+	std::string_view method_name
+) const -> wasm_trap_t* {
+	auto message = std::string{method_name};
+	message += ": guest pointer is out of bounds";
+	return trap(message);
+}
+
+auto instance_env::call_mem_exhausted_trap( //
+	std::string_view method_name
+) const -> wasm_trap_t* {
+	auto message = std::string{method_name};
+	message += ": call memory exhausted";
+	return trap(message);
+}
+
+auto instance_env::ensure_environment() -> const environment_block& {
+	if(!environment) {
+		environment = current_environment();
+	}
+	return *environment;
+}
+
+auto instance_env::component_size( //
+	ecsact_component_like_id component_id
+) -> std::optional<std::size_t> {
+	auto itr = component_sizes.find(component_id);
+	if(itr == component_sizes.end()) {
+		itr = component_sizes
+						.emplace(component_id, component_data_size(component_id))
+						.first;
+	}
+	return itr->second;
+}
+
+auto instance_env::indexed_field_values_size( //
+	ecsact_component_like_id component_id
+) -> std::optional<std::size_t> {
+	auto itr = indexed_field_values_sizes.find(component_id);
+	if(itr == indexed_field_values_sizes.end()) {
+		// Member function of the same name hides the free function
+		auto size = ecsact::wasm::detail::indexed_field_values_size(component_id);
+		itr = indexed_field_values_sizes.emplace(component_id, size).first;
+	}
+	return itr->second;
+}
@@ -0,0 +1,230 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+#include <wasm.h>
+#include "ecsact/runtime/common.h"
+#include "ecsact/si/wasmer/detail/readonly_frame.hh"
+#include "ecsact/si/wasmer/detail/action_cache.hh"
+#include "ecsact/si/wasmer/detail/presence_mask.hh"
+#include "ecsact/si/wasmer/detail/mem_stack.hh"
+#include "ecsact/si/wasmer/detail/context_handles.hh"
+#include "ecsact/si/wasmer/detail/log_rate_limit.hh"
+#include "ecsact/si/wasmer/detail/wasi_fs.hh"
+#include "ecsact/si/wasmer/detail/wasi_env_vars.hh"
+
+namespace ecsact::wasm::detail {
+
+/**
+ * State owned by a single wasm instance. A pointer to this is bound to every
+ * guest import so host calls never have to look up which instance (or which
+ * memory) they are operating on.
+ */
+struct instance_env {
+	wasm_store_t*  store = nullptr;
+	wasm_memory_t* memory = nullptr;
+
+	/**
+	 * Index of this instance in the loaded instance pool
+	 */
+	std::int32_t index = -1;
+
+	/**
+	 * System and entity whose impl is currently executing. Attached to guest
+	 * log writes. -1 outside of system impl calls.
+	 */
+	ecsact_system_like_id current_system_id =
+		static_cast<ecsact_system_like_id>(-1);
+	ecsact_entity_id current_entity = static_cast<ecsact_entity_id>(-1);
+
+	/**
+	 * Random words given to the guest during the current system impl call in
+	 * deterministic mode (see `wasi::clock::random_get`.)
+	 */
+	std::uint64_t random_counter = 0;
+
+	/**
+	 * Rate limit decisions of the lines this instance is in the middle of
+	 * writing to stdout/stderr
+	 */
+	log_line_admission log_admission;
+
+	/**
+	 * Cached `wasm_memory_data(memory)` and `wasm_memory_data_size(memory)`.
+	 * Only valid after `sync_memory()`.
+	 */
+	std::byte*  memory_data = nullptr;
+	std::size_t memory_data_size = 0;
+
+	/**
+	 * Frames registered by the guest that are populated before the guest
+	 * system impl is called.
+	 */
+	std::unordered_map<ecsact_system_like_id, readonly_frame> readonly_frames;
+
+	/**
+	 * Action buffers registered by the guest that are populated before every
+	 * call of the guest action system impl.
+	 */
+	std::unordered_map<ecsact_system_like_id, action_cache> action_caches;
+
+	/**
+	 * Component presence masks registered by the guest that are set before the
+	 * guest system impl is called.
+	 */
+	std::unordered_map<ecsact_system_like_id, presence_mask> presence_masks;
+
+	/**
+	 * Handles of the contexts given to the guest during the current system impl
+	 * call.
+	 */
+	context_handles ctx_handles;
+
+	/**
+	 * Call memory frames pushed by the guest (see
+	 * `ecsact_si_wasm_call_mem_push_frame`.) Frames below `guest_frames_base`
+	 * belong to an outer system impl call and may not be popped by the guest.
+	 */
+	std::vector<call_mem_frame> guest_frames;
+	std::size_t                 guest_frames_base = 0;
+
+	/**
+	 * Most call memory (in bytes) used by a single impl call of each system.
+	 */
+	std::unordered_map<ecsact_system_like_id, std::size_t>
+		call_mem_high_water_marks;
+
+	/**
+	 * WASI file descriptors opened by this instance
+	 */
+	wasi::fs::fd_table fd_table;
+
+	/**
+	 * Environment variables this instance was given. Taken on first use so
+	 * `environ_sizes_get` and `environ_get` always agree.
+	 */
+	std::shared_ptr<const wasi::env_vars::environment_block> environment;
+
+	/**
+	 * Reusable buffer for translating guest component data pointers. Only grows
+	 * so generate calls stop allocating once warmed up.
+	 */
+	std::vector<const void*> components_data_scratch;
+
+	/**
+	 * Cached `component_data_size` of every component the guest passed data
+	 * for. Unknown sizes are cached too.
+	 */
+	std::unordered_map<ecsact_component_like_id, std::optional<std::size_t>>
+		component_sizes;
+
+	/**
+	 * Cached `indexed_field_values_size` of every component the guest passed
+	 * indexed field values for. Unknown sizes are cached too.
+	 */
+	std::unordered_map<ecsact_component_like_id, std::optional<std::size_t>>
+		indexed_field_values_sizes;
+
+	/**
+	 * Refreshes the cached memory data pointer if the guest memory has grown
+	 * since the last host call. Must be called once at the start of every host
+	 * call before translating any guest pointers.
+	 */
+	auto sync_memory() -> void;
+
+	/**
+	 * @returns `environment`, taking the current environment if not set yet
+	 */
+	auto ensure_environment() -> const wasi::env_vars::environment_block&;
+
+	/**
+	 * @returns `component_data_size` of @p component_id, looked up once per
+	 *          instance
+	 */
+	auto component_size( //
+		ecsact_component_like_id component_id
+	) -> std::optional<std::size_t>;
+
+	/**
+	 * @returns `indexed_field_values_size` of @p component_id, looked up once
+	 *          per instance
+	 */
+	auto indexed_field_values_size( //
+		ecsact_component_like_id component_id
+	) -> std::optional<std::size_t>;
+
+	/**
+	 * Translates a guest region registered through one of the
+	 * `ecsact_si_wasm_register_*` imports. Syncs the memory first since
+	 * registered regions are populated outside of host calls.
+	 */
+	auto registered_region( //
+		std::int32_t guest_ptr,
+		std::size_t  size
+	) -> std::byte*;
+
+	/**
+	 * Creates a trap owned by this instance's store. Returning the trap from a
+	 * host call aborts the guest.
+	 */
+	auto trap(std::string_view message) const -> wasm_trap_t*;
+
+	/**
+	 * Trap for a guest passing a pointer to @p method_name that lies outside of
+	 * the guest memory.
+	 */
+	auto out_of_bounds_trap(std::string_view method_name) const -> wasm_trap_t*;
+
+	/**
+	 * Trap for @p method_name running out of call memory, usually because the
+	 * guest walked an unbounded chain of contexts.
+	 */
+	auto call_mem_exhausted_trap( //
+		std::string_view method_name
+	) const -> wasm_trap_t*;
+
+	/**
+	 * Translates a guest pointer to a host pointer.
+	 * @returns `nullptr` if any of the `count` elements starting at @p guest_ptr
+	 *          lie outside of the guest memory.
+	 */
+	template<typename T>
+	auto guest_cast(std::int32_t guest_ptr, std::size_t count = 1) const -> T* {
+		constexpr auto elem_size = [] {
+			if constexpr(std::is_void_v<std::remove_cv_t<T>>) {
+				return std::size_t{1};
+			} else {
+				return sizeof(T);
+			}
+		}();
+
+		// guest pointers are unsigned 32-bit offsets into the guest memory
+		auto offset = std::size_t{static_cast<std::uint32_t>(guest_ptr)};
+		if(offset > memory_data_size) {
+			return nullptr;
+		}
+		if(count > (memory_data_size - offset) / elem_size) {
+			return nullptr;
+		}
+
+		return reinterpret_cast<T*>(memory_data + offset);
+	}
+};
+
+/**
+ * Gets the instance env bound to a guest import and syncs its memory. Called
+ * once at the start of every host call.
+ */
+inline auto get_instance_env(void* env) -> instance_env& {
+	auto& inst_env = *static_cast<instance_env*>(env);
+	inst_env.sync_memory();
+	return inst_env;
+}
+
+} // namespace ecsact::wasm::detail
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+
+namespace ecsact::wasm::detail {
+
+/**
+ * Splits a stream of arbitrarily sized writes into lines. Only the unfinished
+ * tail of the stream is kept, so the cost is linear in the bytes written.
+ * Lines that arrive whole in a single write are emitted straight from the
+ * write without copying.
+ */
+class line_assembler {
+public:
+	/**
+	 * Calls @p on_line with every line completed by @p chunk, without the
+	 * newline. The string view is only valid during the call.
+	 */
+	template<typename OnLine>
+	auto feed(std::string_view chunk, OnLine&& on_line) -> void {
+		auto newline = chunk.find('\n');
+		while(newline != std::string_view::npos) {
+			if(_tail.empty()) {
+				on_line(chunk.substr(0, newline));
+			} else {
+				_tail.append(chunk.substr(0, newline));
+				on_line(std::string_view{_tail});
+				_tail.clear();
+			}
+
+			chunk.remove_prefix(newline + 1);
+			newline = chunk.find('\n');
+		}
+
+		_tail.append(chunk);
+	}
+
+	/**
+	 * Calls @p on_line with the unfinished tail (if any) as if it ended with a
+	 * newline.
+	 */
+	template<typename OnLine>
+	auto finish(OnLine&& on_line) -> void {
+		if(!_tail.empty()) {
+			on_line(std::string_view{_tail});
+			_tail.clear();
+		}
+	}
+
+	/**
+	 * Whether a line has been started but not finished yet
+	 */
+	auto has_tail() const -> bool {
+		return !_tail.empty();
+	}
+
+private:
+	std::string _tail;
+};
+
+} // namespace ecsact::wasm::detail
@@ -0,0 +1,200 @@
+#include "ecsact/si/wasmer/detail/log_file_sink.hh"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+
+#ifdef _WIN32
+#	define WIN32_LEAN_AND_MEAN
+#	define NOMINMAX
+#	include <windows.h>
+#else
+#	include <fcntl.h>
+#	include <sys/mman.h>
+#	include <unistd.h>
+#endif
+
+using ecsact::wasm::detail::log_file_sink;
+
+namespace {
+constexpr auto record_alignment = std::size_t{8};
+
+auto active_sink = std::unique_ptr<log_file_sink>{};
+auto active_sink_ptr = std::atomic<log_file_sink*>{};
+} // namespace
+
+auto log_file_sink::open( //
+	std::string_view path,
+	std::size_t      capacity
+) -> std::unique_ptr<log_file_sink> {
+	if(capacity <= sizeof(ecsact_si_wasmer_log_file_header)) {
+		return nullptr;
+	}
+
+	auto sink = std::unique_ptr<log_file_sink>{new log_file_sink};
+	sink->_path = std::string{path};
+	sink->_capacity = capacity;
+
+#ifdef _WIN32
+	sink->_file = CreateFileA(
+		sink->_path.c_str(),
+		GENERIC_READ | GENERIC_WRITE,
+		FILE_SHARE_READ,
+		nullptr,
+		CREATE_ALWAYS,
+		FILE_ATTRIBUTE_NORMAL,
+		nullptr
+	);
+	if(sink->_file == INVALID_HANDLE_VALUE) {
+		sink->_file = nullptr;
+		return nullptr;
+	}
+
+	auto size = static_cast<std::uint64_t>(capacity);
+	sink->_mapping = CreateFileMappingA(
+		sink->_file,
+		nullptr,
+		PAGE_READWRITE,
+		static_cast<DWORD>(size >> 32),
+		static_cast<DWORD>(size & 0xFFFFFFFF),
+		nullptr
+	);
+	if(sink->_mapping == nullptr) {
+		return nullptr;
+	}
+
+	sink->_data = static_cast<std::byte*>(
+		MapViewOfFile(sink->_mapping, FILE_MAP_ALL_ACCESS, 0, 0, capacity)
+	);
+	if(sink->_data == nullptr) {
+		return nullptr;
+	}
+#else
+	sink->_fd = ::open(sink->_path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+	if(sink->_fd == -1) {
+		return nullptr;
+	}
+
+	if(::ftruncate(sink->_fd, static_cast<off_t>(capacity)) != 0) {
+		return nullptr;
+	}
+
+	auto data =
+		::mmap(nullptr, capacity, PROT_READ | PROT_WRITE, MAP_SHARED, sink->_fd, 0);
+	if(data == MAP_FAILED) {
+		return nullptr;
+	}
+	sink->_data = static_cast<std::byte*>(data);
+#endif
+
+	auto& header = sink->header();
+	std::memcpy(
+		header.magic,
+		ECSACT_SI_WASMER_LOG_FILE_MAGIC,
+		sizeof(header.magic)
+	);
+	header.capacity = capacity;
+	header.write_offset = 0;
+	header.dropped_count = 0;
+
+	return sink;
+}
+
+log_file_sink::~log_file_sink() {
+	constexpr auto header_size = sizeof(ecsact_si_wasmer_log_file_header);
+
+	auto used_size = _capacity;
+	if(_data != nullptr) {
+		auto records_size = std::min<std::size_t>(
+			header().write_offset,
+			_capacity - header_size
+		);
+		used_size = header_size + records_size;
+	}
+
+#ifdef _WIN32
+	if(_data != nullptr) {
+		FlushViewOfFile(_data, 0);
+		UnmapViewOfFile(_data);
+	}
+	if(_mapping != nullptr) {
+		CloseHandle(_mapping);
+	}
+	if(_file != nullptr) {
+		auto end = LARGE_INTEGER{};
+		end.QuadPart = static_cast<LONGLONG>(used_size);
+		SetFilePointerEx(_file, end, nullptr, FILE_BEGIN);
+		SetEndOfFile(_file);
+		CloseHandle(_file);
+	}
+#else
+	if(_data != nullptr) {
+		::msync(_data, _capacity, MS_SYNC);
+		::munmap(_data, _capacity);
+	}
+	if(_fd != -1) {
+		[[maybe_unused]] auto result =
+			::ftruncate(_fd, static_cast<off_t>(used_size));
+		::close(_fd);
+	}
+#endif
+}
+
+auto log_file_sink::header() -> ecsact_si_wasmer_log_file_header& {
+	return *reinterpret_cast<ecsact_si_wasmer_log_file_header*>(_data);
+}
+
+auto log_file_sink::write(
+	ecsact_si_wasm_log_level level,
+	const log_attribution&   attribution,
+	std::string_view         str
+) -> bool {
+	auto record_size = sizeof(ecsact_si_wasmer_log_file_record) + str.size();
+	record_size = (record_size + record_alignment - 1) & ~(record_alignment - 1);
+
+	auto records_capacity = _capacity - sizeof(ecsact_si_wasmer_log_file_header);
+	auto offset = std::atomic_ref{header().write_offset}.fetch_add(
+		record_size,
+		std::memory_order_relaxed
+	);
+
+	if(offset + record_size > records_capacity) {
+		std::atomic_ref{header().dropped_count}.fetch_add(
+			1,
+			std::memory_order_relaxed
+		);
+		return false;
+	}
+
+	auto record_data =
+		_data + sizeof(ecsact_si_wasmer_log_file_header) + offset;
+	auto record =
+		reinterpret_cast<ecsact_si_wasmer_log_file_record*>(record_data);
+	record->log_level = static_cast<std::int32_t>(level);
+	record->system_id = static_cast<std::int32_t>(attribution.system_id);
+	record->entity = static_cast<std::int32_t>(attribution.entity);
+	record->instance_index = attribution.instance_index;
+	record->message_length = static_cast<std::uint32_t>(str.size());
+	record->thread_id = attribution.thread_id;
+	record->timestamp_ns = attribution.timestamp_ns;
+	std::memcpy(record + 1, str.data(), str.size());
+
+	// Committing the size last lets readers tell a torn record apart
+	std::atomic_ref{record->record_size}.store(
+		static_cast<std::uint32_t>(record_size),
+		std::memory_order_release
+	);
+
+	return true;
+}
+
+auto ecsact::wasm::detail::active_log_file_sink() -> log_file_sink* {
+	return active_sink_ptr.load(std::memory_order_acquire);
+}
+
+auto ecsact::wasm::detail::set_active_log_file_sink( //
+	std::unique_ptr<log_file_sink> sink
+) -> void {
+	active_sink_ptr.store(sink.get(), std::memory_order_release);
+	active_sink = std::move(sink);
+}
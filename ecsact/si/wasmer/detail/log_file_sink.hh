@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include "ecsact/si/wasm.h"
+#include "ecsact/si/wasmer/log_file.h"
+#include "ecsact/si/wasmer/detail/log_ring.hh"
+
+namespace ecsact::wasm::detail {
+
+/**
+ * Memory mapped binary log file (see `ecsact/si/wasmer/log_file.h`.) Writers
+ * reserve space with a single atomic add on the mapped header and copy their
+ * record in place, so any number of threads may write at once.
+ */
+class log_file_sink {
+public:
+	static auto open( //
+		std::string_view path,
+		std::size_t      capacity
+	) -> std::unique_ptr<log_file_sink>;
+
+	log_file_sink(const log_file_sink&) = delete;
+	~log_file_sink();
+
+	/**
+	 * @returns `false` if the file is full and the write was dropped
+	 */
+	auto write(
+		ecsact_si_wasm_log_level level,
+		const log_attribution&   attribution,
+		std::string_view         str
+	) -> bool;
+
+private:
+	log_file_sink() = default;
+
+	std::string _path;
+	std::byte*  _data = nullptr;
+	std::size_t _capacity = 0;
+#ifdef _WIN32
+	void* _file = nullptr;
+	void* _mapping = nullptr;
+#else
+	int _fd = -1;
+#endif
+
+	auto header() -> ecsact_si_wasmer_log_file_header&;
+};
+
+/**
+ * Sink guest stdio writes go to instead of the log rings or `nullptr`
+ */
+auto active_log_file_sink() -> log_file_sink*;
+
+auto set_active_log_file_sink(std::unique_ptr<log_file_sink> sink) -> void;
+
+} // namespace ecsact::wasm::detail
@@ -0,0 +1,202 @@
+#include "ecsact/si/wasmer/detail/log_rate_limit.hh"
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "ecsact/si/wasmer/detail/logger.hh"
+
+using ecsact::wasm::detail::log_line_entry;
+using ecsact::wasm::detail::log_rate_limit;
+
+namespace {
+struct log_rate_limit_state {
+	ecsact_system_like_id    system_id;
+	ecsact_si_wasm_log_level level;
+	log_rate_limit           limit;
+
+	// Fixed one second windows. Racing threads may both reset a new window
+	// which at worst admits a few extra lines.
+	std::atomic_int64_t window = 0;
+	std::atomic_int64_t window_lines_count = 0;
+	std::atomic_int64_t lines_count = 0;
+	std::atomic_int64_t suppressed_lines_count = 0;
+};
+
+constexpr auto any_system_id = static_cast<ecsact_system_like_id>(-1);
+
+auto rate_limit_key( //
+	ecsact_system_like_id    system_id,
+	ecsact_si_wasm_log_level level
+) -> std::uint64_t {
+	return (static_cast<std::uint64_t>(static_cast<std::uint32_t>(system_id))
+					<< 32) |
+		static_cast<std::uint32_t>(level);
+}
+
+auto level_name(ecsact_si_wasm_log_level level) -> std::string_view {
+	switch(level) {
+		case ECSACT_SI_WASM_LOG_LEVEL_INFO:
+			return " info";
+		case ECSACT_SI_WASM_LOG_LEVEL_WARNING:
+			return " warning";
+		case ECSACT_SI_WASM_LOG_LEVEL_ERROR:
+			return " error";
+	}
+	return "";
+}
+
+/**
+ * Limits are never modified once published. Setting or clearing a limit
+ * publishes a new table, `fd_write` only loads the current table pointer.
+ */
+struct log_rate_limits_table {
+	std::unordered_map<std::uint64_t, log_rate_limit_state*> states;
+};
+
+/**
+ * Every table and state ever published. Kept until exit so writers never
+ * need a reference to read the current table. Limits are configured rarely
+ * so these stay small.
+ */
+auto rate_limits_mutex = std::mutex{};
+auto published_rate_limits =
+	std::vector<std::unique_ptr<const log_rate_limits_table>>{};
+auto rate_limit_states = std::vector<std::unique_ptr<log_rate_limit_state>>{};
+
+auto empty_rate_limits = log_rate_limits_table{};
+auto rate_limits = std::atomic<const log_rate_limits_table*>{
+	&empty_rate_limits,
+};
+
+auto find_state(
+	const log_rate_limits_table& table,
+	ecsact_system_like_id        system_id,
+	ecsact_si_wasm_log_level     level
+) -> log_rate_limit_state* {
+	auto itr = table.states.find(rate_limit_key(system_id, level));
+	if(itr == table.states.end()) {
+		itr = table.states.find(rate_limit_key(any_system_id, level));
+	}
+
+	return itr != table.states.end() ? itr->second : nullptr;
+}
+
+/**
+ * Must be called with `rate_limits_mutex` locked
+ */
+auto publish_rate_limits(std::unique_ptr<const log_rate_limits_table> table)
+	-> void {
+	rate_limits.store(table.get(), std::memory_order_release);
+	published_rate_limits.push_back(std::move(table));
+}
+
+auto summarize_suppressed_lines(
+	log_rate_limit_state&        state,
+	std::vector<log_line_entry>& summaries
+) -> void {
+	auto suppressed_count =
+		state.suppressed_lines_count.exchange(0, std::memory_order_relaxed);
+	if(suppressed_count == 0) {
+		return;
+	}
+
+	auto message = std::string{"suppressed "};
+	message += std::to_string(suppressed_count);
+	message += level_name(state.level);
+	message += " log line(s) by rate limit";
+
+	summaries.push_back(log_line_entry{
+		.log_level = ECSACT_SI_WASM_LOG_LEVEL_WARNING,
+		.message = std::move(message),
+		.attribution = {.system_id = state.system_id},
+	});
+}
+} // namespace
+
+auto ecsact::wasm::detail::set_log_rate_limit(
+	ecsact_system_like_id    system_id,
+	ecsact_si_wasm_log_level level,
+	log_rate_limit           limit
+) -> void {
+	auto state = std::make_unique<log_rate_limit_state>();
+	state->system_id = system_id;
+	state->level = level;
+	state->limit = limit;
+
+	auto lk = std::scoped_lock{rate_limits_mutex};
+	auto table = std::make_unique<log_rate_limits_table>(
+		*rate_limits.load(std::memory_order_relaxed)
+	);
+	table->states.insert_or_assign(rate_limit_key(system_id, level), state.get());
+	rate_limit_states.push_back(std::move(state));
+	publish_rate_limits(std::move(table));
+}
+
+auto ecsact::wasm::detail::clear_log_rate_limits() -> void {
+	auto lk = std::scoped_lock{rate_limits_mutex};
+	publish_rate_limits(std::make_unique<const log_rate_limits_table>());
+}
+
+auto ecsact::wasm::detail::admit_log_line(
+	ecsact_system_like_id    system_id,
+	ecsact_si_wasm_log_level level
+) -> bool {
+	auto table = rate_limits.load(std::memory_order_acquire);
+	if(table->states.empty()) {
+		return true;
+	}
+
+	auto state = find_state(*table, system_id, level);
+	if(state == nullptr) {
+		return true;
+	}
+
+	auto suppress = [&] {
+		state->suppressed_lines_count.fetch_add(1, std::memory_order_relaxed);
+		return false;
+	};
+
+	if(state->limit.sample_every > 1) {
+		auto line_index =
+			state->lines_count.fetch_add(1, std::memory_order_relaxed);
+		if(line_index % state->limit.sample_every != 0) {
+			return suppress();
+		}
+	}
+
+	if(state->limit.max_lines_per_second > 0) {
+		auto now = std::chrono::steady_clock::now().time_since_epoch();
+		auto window = std::chrono::duration_cast<std::chrono::seconds>(now).count();
+		auto current_window = state->window.load(std::memory_order_relaxed);
+		if(current_window != window &&
+			 state->window.compare_exchange_strong(current_window, window)) {
+			state->window_lines_count.store(0, std::memory_order_relaxed);
+		}
+
+		auto window_lines_count =
+			state->window_lines_count.fetch_add(1, std::memory_order_relaxed);
+		if(window_lines_count >= state->limit.max_lines_per_second) {
+			return suppress();
+		}
+	}
+
+	return true;
+}
+
+auto ecsact::wasm::detail::take_suppressed_log_summaries()
+	-> std::vector<log_line_entry> {
+	auto result = std::vector<log_line_entry>{};
+	auto lk = std::scoped_lock{rate_limits_mutex};
+
+	// Writers holding an older table may still count lines on replaced states
+	for(auto& state : rate_limit_states) {
+		summarize_suppressed_lines(*state, result);
+	}
+
+	return result;
+}
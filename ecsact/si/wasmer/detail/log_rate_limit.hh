@@ -0,0 +1,121 @@
+#pragma once
+
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include <vector>
+#include "ecsact/si/wasm.h"
+#include "ecsact/runtime/common.h"
+
+namespace ecsact::wasm::detail {
+
+struct log_line_entry;
+
+struct log_rate_limit {
+	/**
+	 * Most lines admitted per second. `0` means unlimited.
+	 */
+	std::int32_t max_lines_per_second = 0;
+
+	/**
+	 * Only every Nth line is admitted. `0` and `1` admit every line.
+	 */
+	std::int32_t sample_every = 1;
+};
+
+/**
+ * Sets the rate limit of @p level writes by @p system_id. A @p system_id of -1
+ * sets the limit of systems without a limit of their own. Lines suppressed by
+ * a replaced limit are still summarized.
+ */
+auto set_log_rate_limit(
+	ecsact_system_like_id    system_id,
+	ecsact_si_wasm_log_level level,
+	log_rate_limit           limit
+) -> void;
+
+/**
+ * Removes every limit. Lines suppressed by the removed limits are still
+ * summarized.
+ */
+auto clear_log_rate_limits() -> void;
+
+/**
+ * Hot path check done once per line (see `log_line_admission`.) Suppressed
+ * lines are only counted.
+ *
+ * @returns `true` if the line should be logged
+ */
+auto admit_log_line(
+	ecsact_system_like_id    system_id,
+	ecsact_si_wasm_log_level level
+) -> bool;
+
+/**
+ * Admission of the lines a single instance is in the middle of writing. Guest
+ * lines may arrive in many `fd_write` fragments. Every fragment of a line gets
+ * the decision `admit_log_line` made when the first fragment arrived.
+ */
+class log_line_admission {
+public:
+	/**
+	 * Calls @p on_admitted with the parts of @p chunk that belong to admitted
+	 * lines. Parts keep their newlines.
+	 */
+	template<typename OnAdmitted>
+	auto feed(
+		ecsact_system_like_id    system_id,
+		ecsact_si_wasm_log_level level,
+		std::string_view         chunk,
+		OnAdmitted&&             on_admitted
+	) -> void {
+		assert(static_cast<std::size_t>(level) < _line_admitted.size());
+		auto& line_admitted = _line_admitted[level];
+		auto  admitted_begin = std::size_t{};
+		auto  part_begin = std::size_t{};
+
+		while(chunk.size() > part_begin) {
+			auto newline = chunk.find('\n', part_begin);
+			auto part_end =
+				newline == std::string_view::npos ? chunk.size() : newline + 1;
+
+			if(!line_admitted) {
+				line_admitted = admit_log_line(system_id, level);
+			}
+
+			if(!*line_admitted) {
+				if(part_begin > admitted_begin) {
+					on_admitted(
+						chunk.substr(admitted_begin, part_begin - admitted_begin)
+					);
+				}
+				admitted_begin = part_end;
+			}
+
+			if(newline != std::string_view::npos) {
+				line_admitted.reset();
+			}
+			part_begin = part_end;
+		}
+
+		if(part_begin > admitted_begin) {
+			on_admitted(chunk.substr(admitted_begin, part_begin - admitted_begin));
+		}
+	}
+
+private:
+	/**
+	 * Decision for the unfinished line of each log level, if one was started
+	 */
+	std::array<std::optional<bool>, 3> _line_admitted;
+};
+
+/**
+ * Creates a warning line for every system and level that had lines suppressed
+ * since the last call.
+ */
+auto take_suppressed_log_summaries() -> std::vector<log_line_entry>;
+
+} // namespace ecsact::wasm::detail
@@ -0,0 +1,115 @@
+#include "ecsact/si/wasmer/detail/log_ring.hh"
+
+#include <bit>
+#include <cstring>
+
+using ecsact::wasm::detail::log_overflow_policy;
+using ecsact::wasm::detail::log_ring;
+
+log_ring::log_ring(std::size_t capacity)
+	: _capacity(std::bit_ceil(std::max(capacity, std::size_t{64}))) {
+	_data = std::make_unique_for_overwrite<std::byte[]>(_capacity);
+}
+
+auto log_ring::read( //
+	std::uint64_t pos,
+	void*         out,
+	std::size_t   size
+) const -> void {
+	auto index = static_cast<std::size_t>(pos & (_capacity - 1));
+	auto first = std::min(size, _capacity - index);
+	std::memcpy(out, _data.get() + index, first);
+	std::memcpy(static_cast<std::byte*>(out) + first, _data.get(), size - first);
+}
+
+auto log_ring::write( //
+	std::uint64_t pos,
+	const void*   in,
+	std::size_t   size
+) -> void {
+	auto index = static_cast<std::size_t>(pos & (_capacity - 1));
+	auto first = std::min(size, _capacity - index);
+	std::memcpy(_data.get() + index, in, first);
+	std::memcpy(
+		_data.get(),
+		static_cast<const std::byte*>(in) + first,
+		size - first
+	);
+}
+
+auto log_ring::push(
+	ecsact_si_wasm_log_level level,
+	const log_attribution&   attribution,
+	std::string_view         str,
+	log_overflow_policy      policy
+) -> std::size_t {
+	auto record_size = sizeof(record_header) + str.size();
+	if(record_size > _capacity) {
+		return 1;
+	}
+
+	auto dropped_count = std::size_t{};
+	auto head = _head.load(std::memory_order_relaxed);
+	auto tail = _tail.load(std::memory_order_acquire);
+
+	while(head - tail + record_size > _capacity) {
+		if(policy == log_overflow_policy::drop_newest) {
+			return 1;
+		}
+
+		// Only the producer writes records so reading the header at tail is safe
+		// even while the consumer is reading the same record.
+		auto oldest = record_header{};
+		read(tail, &oldest, sizeof(oldest));
+		auto next_tail = tail + sizeof(record_header) + oldest.size;
+		if(_tail.compare_exchange_weak(
+				 tail,
+				 next_tail,
+				 std::memory_order_acq_rel
+			 )) {
+			tail = next_tail;
+			dropped_count += 1;
+		}
+	}
+
+	auto header = record_header{
+		.size = static_cast<std::uint32_t>(str.size()),
+		.level = level,
+		.attribution = attribution,
+	};
+	write(head, &header, sizeof(header));
+	write(head + sizeof(header), str.data(), str.size());
+	_head.store(head + record_size, std::memory_order_release);
+
+	return dropped_count;
+}
+
+auto log_ring::pop(record_header& out_header, std::string& out) -> bool {
+	auto tail = _tail.load(std::memory_order_acquire);
+
+	for(;;) {
+		auto head = _head.load(std::memory_order_acquire);
+		if(tail == head) {
+			return false;
+		}
+
+		auto header = record_header{};
+		read(tail, &header, sizeof(header));
+
+		// The producer may drop this record (drop_oldest) and overwrite it while
+		// it is copied. The copy is only trusted if tail didn't move meanwhile.
+		auto size = std::min<std::size_t>(header.size, _capacity);
+		out.resize(size);
+		read(tail + sizeof(header), out.data(), size);
+
+		auto next_tail = tail + sizeof(header) + size;
+		if(_tail.compare_exchange_strong(
+				 tail,
+				 next_tail,
+				 std::memory_order_acq_rel
+			 )) {
+			out_header = header;
+			return true;
+		}
+	}
+}
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include "ecsact/si/wasm.h"
+#include "ecsact/runtime/common.h"
+
+namespace ecsact::wasm::detail {
+
+/**
+ * Where and when a log write happened
+ */
+struct log_attribution {
+	/**
+	 * System whose impl was executing or -1 for writes outside of system impls
+	 * (e.g. during module initialization)
+	 */
+	ecsact_system_like_id system_id = static_cast<ecsact_system_like_id>(-1);
+	ecsact_entity_id      entity = static_cast<ecsact_entity_id>(-1);
+	std::int32_t          instance_index = -1;
+	std::uint64_t         thread_id = 0;
+
+	/**
+	 * `std::chrono::steady_clock` time since epoch in nanoseconds
+	 */
+	std::int64_t timestamp_ns = 0;
+};
+
+enum class log_overflow_policy {
+	/**
+	 * Writes that don't fit are discarded
+	 */
+	drop_newest,
+
+	/**
+	 * The oldest unconsumed writes are discarded to make room
+	 */
+	drop_oldest,
+};
+
+/**
+ * Lock-free single producer, single consumer ring buffer of log writes. Each
+ * thread that logs owns one ring and is its only producer. The consumer must
+ * be serialized by the caller.
+ */
+class log_ring {
+public:
+	/**
+	 * @param capacity size of the ring in bytes. Rounded up to a power of two.
+	 */
+	explicit log_ring(std::size_t capacity);
+
+	/**
+	 * Producer side. Appends @p str and @p attribution as a single record.
+	 * @returns number of records dropped to honour @p policy (including @p str
+	 *          itself when it was dropped)
+	 */
+	auto push(
+		ecsact_si_wasm_log_level level,
+		const log_attribution&   attribution,
+		std::string_view         str,
+		log_overflow_policy      policy
+	) -> std::size_t;
+
+	/**
+	 * Consumer side. Calls @p fn with every record in the order they were
+	 * pushed. @p fn receives `(ecsact_si_wasm_log_level, const
+	 * log_attribution&, std::string_view)`. The string view is only valid
+	 * during the call.
+	 */
+	template<typename Fn>
+	auto drain(Fn&& fn) -> void {
+		while(pop(_drain_header, _drain_scratch)) {
+			fn(
+				_drain_header.level,
+				_drain_header.attribution,
+				std::string_view{_drain_scratch}
+			);
+		}
+	}
+
+private:
+	struct record_header {
+		std::uint32_t            size;
+		ecsact_si_wasm_log_level level;
+		log_attribution          attribution;
+	};
+
+	std::unique_ptr<std::byte[]> _data;
+	std::size_t                  _capacity;
+
+	// Monotonic positions. Masked with `_capacity - 1` to index `_data`.
+	alignas(64) std::atomic_uint64_t _head = 0;
+	alignas(64) std::atomic_uint64_t _tail = 0;
+
+	std::string   _drain_scratch;
+	record_header _drain_header = {};
+
+	auto pop(record_header& out_header, std::string& out) -> bool;
+	auto read(std::uint64_t pos, void* out, std::size_t size) const -> void;
+	auto write(std::uint64_t pos, const void* in, std::size_t size) -> void;
+};
+
+} // namespace ecsact::wasm::detail
@@ -0,0 +1,37 @@
+#include "ecsact/si/wasmer/detail/log_stream.hh"
+
+using ecsact::wasm::detail::log_stream;
+
+log_stream::log_stream(
+	deliver_fn_t              deliver,
+	std::chrono::milliseconds flush_interval
+)
+	: _deliver(std::move(deliver)), _flush_interval(flush_interval) {
+	// Started last so every member is initialized before the thread runs
+	_thread = std::jthread{[this](std::stop_token stop) { run(stop); }};
+}
+
+log_stream::~log_stream() {
+	_thread.request_stop();
+	_thread.join();
+	flush();
+}
+
+auto log_stream::run(std::stop_token stop) -> void {
+	while(!stop.stop_requested()) {
+		{
+			// Only a stop request wakes the thread before the interval is up
+			auto lk = std::unique_lock{_mutex};
+			_cv.wait_for(lk, stop, _flush_interval, [] { return false; });
+		}
+
+		flush();
+	}
+}
+
+auto log_stream::flush() -> void {
+	// Collected under the logger lock, delivered outside of it
+	for(auto& entry : take_log_lines()) {
+		_deliver(entry);
+	}
+}
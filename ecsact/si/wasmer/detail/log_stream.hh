@@ -0,0 +1,40 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <stop_token>
+#include <thread>
+#include "ecsact/si/wasmer/detail/logger.hh"
+
+namespace ecsact::wasm::detail {
+
+/**
+ * Delivers completed log lines to a consumer from a dedicated thread. Every
+ * `flush_interval` the thread drains the per-thread log rings and hands the
+ * whole batch to the consumer without holding any logger lock. Destroying the
+ * stream delivers whatever is left and joins the thread.
+ */
+class log_stream {
+public:
+	using deliver_fn_t = std::function<void(const log_line_entry&)>;
+
+	log_stream(deliver_fn_t deliver, std::chrono::milliseconds flush_interval);
+
+	log_stream(const log_stream&) = delete;
+	~log_stream();
+
+private:
+	deliver_fn_t              _deliver;
+	std::chrono::milliseconds _flush_interval;
+
+	std::mutex                  _mutex;
+	std::condition_variable_any _cv;
+	std::jthread                _thread;
+
+	auto run(std::stop_token stop) -> void;
+	auto flush() -> void;
+};
+
+} // namespace ecsact::wasm::detail
@@ -1,19 +1,67 @@
 #include "ecsact/si/wasmer/detail/logger.hh"
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <functional>
+#include <thread>
+#include <memory>
 #include <mutex>
-#include <map>
 #include <string>
 #include <string_view>
+#include <vector>
+#include "ecsact/si/wasmer/detail/log_ring.hh"
+#include "ecsact/si/wasmer/detail/line_assembler.hh"
+#include "ecsact/si/wasmer/detail/log_rate_limit.hh"
+
+using ecsact::wasm::detail::line_assembler;
+using ecsact::wasm::detail::log_attribution;
+using ecsact::wasm::detail::log_line_entry;
+using ecsact::wasm::detail::log_overflow_policy;
+using ecsact::wasm::detail::log_ring;
 
 static auto _logger_mutex = std::recursive_mutex{};
 static auto _logger_entries =
 	std::vector<ecsact::wasm::detail::log_line_entry>{};
-static auto _stdio_strings = [] {
-	return std::map<ecsact_si_wasm_log_level, std::string>{
-		{ECSACT_SI_WASM_LOG_LEVEL_INFO, {}},
-		{ECSACT_SI_WASM_LOG_LEVEL_ERROR, {}},
+
+static auto _log_ring_capacity = std::atomic_size_t{64 * 1024};
+static auto _log_overflow_policy =
+	std::atomic<log_overflow_policy>{log_overflow_policy::drop_newest};
+static auto _dropped_log_writes = std::atomic_uint64_t{};
+
+/**
+ * Ring of a logging thread and the consumer side line state of each log level
+ * written to it. Lines are assembled per source so writes from different
+ * threads never interleave within a line.
+ */
+struct log_source {
+	struct level_lines {
+		line_assembler  assembler;
+		log_attribution tail_attribution;
 	};
-}();
+
+	std::shared_ptr<log_ring>  ring;
+	std::array<level_lines, 3> levels;
+};
+
+// Every ring created by a logging thread. Only locked when a thread logs for
+// the first time and while draining.
+static auto _log_sources_mutex = std::mutex{};
+static auto _log_sources = std::vector<log_source>{};
+
+static thread_local auto _thread_log_ring = std::shared_ptr<log_ring>{};
+
+static auto thread_log_ring() -> log_ring& {
+	if(!_thread_log_ring) {
+		_thread_log_ring = std::make_shared<log_ring>(_log_ring_capacity);
+		std::scoped_lock lk(_log_sources_mutex);
+		_log_sources.push_back(log_source{.ring = _thread_log_ring});
+	}
+
+	return *_thread_log_ring;
+}
 
 ecsact::wasm::detail::log_transaction::log_transaction(std::recursive_mutex& m)
 	: _lk(m) {
@@ -46,45 +94,130 @@ auto ecsact::wasm::detail::clear_log_lines(const log_transaction&) -> void {
 	_logger_entries.clear();
 }
 
+auto ecsact::wasm::detail::stamp_log_attribution( //
+	log_attribution attribution
+) -> log_attribution {
+	static thread_local const auto thread_id =
+		static_cast<std::uint64_t>(std::hash<std::thread::id>{}( //
+			std::this_thread::get_id()
+		));
+
+	attribution.thread_id = thread_id;
+	attribution.timestamp_ns =
+		std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::steady_clock::now().time_since_epoch()
+		)
+			.count();
+
+	return attribution;
+}
+
 auto ecsact::wasm::detail::push_stdio_str(
 	ecsact_si_wasm_log_level level,
+	log_attribution          attribution,
 	std::string_view         str
 ) -> void {
-	std::scoped_lock lk(_logger_mutex);
-	_stdio_strings[level] += std::string(str);
+	auto dropped_count = thread_log_ring().push(
+		level,
+		stamp_log_attribution(attribution),
+		str,
+		_log_overflow_policy.load(std::memory_order_relaxed)
+	);
+
+	if(dropped_count > 0) {
+		_dropped_log_writes.fetch_add(dropped_count, std::memory_order_relaxed);
+	}
+}
+
+auto ecsact::wasm::detail::set_log_overflow_policy( //
+	log_overflow_policy policy
+) -> void {
+	_log_overflow_policy = policy;
+}
+
+auto ecsact::wasm::detail::set_log_ring_capacity( //
+	std::size_t capacity
+) -> void {
+	_log_ring_capacity = capacity;
+}
+
+auto ecsact::wasm::detail::dropped_log_writes() -> std::uint64_t {
+	return _dropped_log_writes.load(std::memory_order_relaxed);
 }
 
 auto ecsact::wasm::detail::consume_stdio_str_as_log_lines(
 	const log_transaction&
 ) -> std::vector<log_line_entry> {
-	using namespace std::string_view_literals;
-
 	auto result = std::vector<log_line_entry>{};
+	std::scoped_lock lk(_log_sources_mutex);
+
+	for(auto& source : _log_sources) {
+		source.ring->drain([&](auto log_level, auto& attribution, auto str) {
+			assert(static_cast<std::size_t>(log_level) < source.levels.size());
+			auto& lines = source.levels[log_level];
+
+			// A line is attributed to the write that started it
+			auto line_attribution = lines.assembler.has_tail() //
+				? lines.tail_attribution
+				: attribution;
+
+			lines.assembler.feed(str, [&](std::string_view line) {
+				if(!line.empty()) {
+					result.push_back(log_line_entry{
+						log_level,
+						std::string{line},
+						line_attribution,
+					});
+				}
+				line_attribution = attribution;
+			});
 
-	for(auto&& [log_level, str] : _stdio_strings) {
-		if(str.empty()) {
-			continue;
+			lines.tail_attribution = line_attribution;
+		});
+	}
+
+	// Rings only referenced here belong to threads that have exited and were
+	// just emptied. Their unfinished lines won't be completed anymore.
+	std::erase_if(_log_sources, [&](log_source& source) {
+		if(source.ring.use_count() > 1) {
+			return false;
 		}
 
-		auto idx = 0;
-		while(idx != std::string::npos) {
-			auto next_idx = str.find('\n', idx + 1);
-			auto message = str.substr(idx + 1, next_idx);
-			idx = next_idx;
-			if(message.empty()) {
-				continue;
-			}
-
-			result.push_back(
-				log_line_entry{
-					.log_level = log_level,
-					.message = message,
-				}
-			);
+		for(auto i = std::size_t{}; source.levels.size() > i; ++i) {
+			auto  log_level = static_cast<ecsact_si_wasm_log_level>(i);
+			auto& lines = source.levels[i];
+			lines.assembler.finish([&](std::string_view line) {
+				result.push_back(log_line_entry{
+					log_level,
+					std::string{line},
+					lines.tail_attribution,
+				});
+			});
 		}
-	}
+		return true;
+	});
 
-	_stdio_strings.clear();
+	return result;
+}
+
+auto ecsact::wasm::detail::take_log_lines() -> std::vector<log_line_entry> {
+	auto t = start_transaction();
+	auto result = std::vector<log_line_entry>{};
+	result.swap(_logger_entries);
+
+	auto stdio_lines = consume_stdio_str_as_log_lines(t);
+	result.insert(
+		result.end(),
+		std::make_move_iterator(stdio_lines.begin()),
+		std::make_move_iterator(stdio_lines.end())
+	);
+
+	auto suppressed_summaries = take_suppressed_log_summaries();
+	result.insert(
+		result.end(),
+		std::make_move_iterator(suppressed_summaries.begin()),
+		std::make_move_iterator(suppressed_summaries.end())
+	);
 
 	return result;
 }
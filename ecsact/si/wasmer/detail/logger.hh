@@ -1,16 +1,20 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
 #include <string>
 #include <mutex>
 #include <vector>
 
 #include "ecsact/si/wasm.h"
+#include "ecsact/si/wasmer/detail/log_ring.hh"
 
 namespace ecsact::wasm::detail {
 
 struct log_line_entry {
 	ecsact_si_wasm_log_level log_level = {};
 	std::string              message;
+	log_attribution          attribution;
 };
 
 class log_transaction {
@@ -33,12 +37,33 @@ auto get_log_lines(const log_transaction& transaction)
 
 auto clear_log_lines(const log_transaction& transaction) -> void;
 
+// Copy of @p attribution with the calling thread's id and the current
+// timestamp filled in.
+auto stamp_log_attribution(log_attribution attribution) -> log_attribution;
+
 // Safely push string from stdio to a queue that will be consumed later in
-// proper log lines.
-auto push_stdio_str(ecsact_si_wasm_log_level level, std::string_view str)
-	-> void;
+// proper log lines. Lock-free, each thread writes to its own ring buffer. The
+// thread id and timestamp of @p attribution are filled in here.
+auto push_stdio_str(
+	ecsact_si_wasm_log_level level,
+	log_attribution          attribution,
+	std::string_view         str
+) -> void;
+
+auto set_log_overflow_policy(log_overflow_policy policy) -> void;
+
+// Size of ring buffers created from now on. Threads that already logged keep
+// their ring.
+auto set_log_ring_capacity(std::size_t capacity) -> void;
+
+// Number of stdio writes dropped because a thread's ring buffer was full.
+auto dropped_log_writes() -> std::uint64_t;
 
 auto consume_stdio_str_as_log_lines(const log_transaction& transaction)
 	-> std::vector<log_line_entry>;
 
+// Takes every pending log line (pushed lines first, then stdio lines) in a
+// single transaction. The caller delivers them without holding the lock.
+auto take_log_lines() -> std::vector<log_line_entry>;
+
 } // namespace ecsact::wasm::detail
@@ -0,0 +1,107 @@
+#include "ecsact/si/wasmer/detail/mapped_file.hh"
+
+#ifdef _WIN32
+#	define WIN32_LEAN_AND_MEAN
+#	define NOMINMAX
+#	include <windows.h>
+#else
+#	include <fcntl.h>
+#	include <sys/mman.h>
+#	include <sys/stat.h>
+#	include <unistd.h>
+#endif
+
+using ecsact::wasm::detail::mapped_file;
+
+auto mapped_file::open(const std::string& path)
+	-> std::shared_ptr<const mapped_file> {
+	auto file = std::shared_ptr<mapped_file>{new mapped_file};
+
+#ifdef _WIN32
+	file->_file = CreateFileA(
+		path.c_str(),
+		GENERIC_READ,
+		FILE_SHARE_READ,
+		nullptr,
+		OPEN_EXISTING,
+		FILE_ATTRIBUTE_NORMAL,
+		nullptr
+	);
+	if(file->_file == INVALID_HANDLE_VALUE) {
+		file->_file = nullptr;
+		return nullptr;
+	}
+
+	auto size = LARGE_INTEGER{};
+	if(!GetFileSizeEx(file->_file, &size)) {
+		return nullptr;
+	}
+
+	// Zero sized files cannot be mapped
+	if(size.QuadPart == 0) {
+		return file;
+	}
+
+	file->_mapping =
+		CreateFileMappingA(file->_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if(file->_mapping == nullptr) {
+		return nullptr;
+	}
+
+	file->_data = static_cast<const std::byte*>(
+		MapViewOfFile(file->_mapping, FILE_MAP_READ, 0, 0, 0)
+	);
+	if(file->_data == nullptr) {
+		return nullptr;
+	}
+	file->_size = static_cast<std::size_t>(size.QuadPart);
+#else
+	auto fd = ::open(path.c_str(), O_RDONLY);
+	if(fd == -1) {
+		return nullptr;
+	}
+
+	// The mapping keeps the file alive on its own
+	struct stat st {};
+	auto        stat_result = ::fstat(fd, &st);
+	if(stat_result != 0 || !S_ISREG(st.st_mode)) {
+		::close(fd);
+		return nullptr;
+	}
+
+	if(st.st_size == 0) {
+		::close(fd);
+		return file;
+	}
+
+	auto size = static_cast<std::size_t>(st.st_size);
+	auto data = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+	::close(fd);
+	if(data == MAP_FAILED) {
+		return nullptr;
+	}
+
+	file->_data = static_cast<const std::byte*>(data);
+	file->_size = size;
+#endif
+
+	return file;
+}
+
+mapped_file::~mapped_file() {
+#ifdef _WIN32
+	if(_data != nullptr) {
+		UnmapViewOfFile(_data);
+	}
+	if(_mapping != nullptr) {
+		CloseHandle(_mapping);
+	}
+	if(_file != nullptr) {
+		CloseHandle(_file);
+	}
+#else
+	if(_data != nullptr) {
+		::munmap(const_cast<std::byte*>(_data), _size);
+	}
+#endif
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <string>
+
+namespace ecsact::wasm::detail {
+
+/**
+ * Read-only memory mapping of a whole file. Mappings are meant to be shared by
+ * every instance reading the file, so reads are a copy out of the page cache
+ * instead of a syscall per read.
+ */
+class mapped_file {
+public:
+	/**
+	 * @returns `nullptr` if @p path could not be opened or mapped
+	 */
+	static auto open(const std::string& path)
+		-> std::shared_ptr<const mapped_file>;
+
+	mapped_file(const mapped_file&) = delete;
+	~mapped_file();
+
+	auto data() const -> std::span<const std::byte> {
+		return {_data, _size};
+	}
+
+private:
+	mapped_file() = default;
+
+	const std::byte* _data = nullptr;
+	std::size_t      _size = 0;
+#ifdef _WIN32
+	void* _file = nullptr;
+	void* _mapping = nullptr;
+#endif
+};
+
+} // namespace ecsact::wasm::detail
@@ -1,91 +1,181 @@
 #include "ecsact/si/wasmer/detail/mem_stack.hh"
 
+#include <algorithm>
+#include <array>
 #include <cassert>
 #include <cstdint>
-#include <atomic>
-#include <optional>
-#include <span>
-#include <typeindex>
-#include <unordered_map>
-#include <map>
+#include <memory>
 #include <vector>
-#include <string_view>
-#include <cstring>
 
 namespace {
-struct call_mem_info_t {
-	std::span<std::byte> data;
-	std::size_t          data_offset = 0;
-#ifndef NDEBUG
-	std::map<std::size_t, const char*> data_offset_types;
-	std::vector<std::string_view>      method_trace;
+/**
+ * Allocations never straddle segments so a segment is also the largest
+ * possible single allocation.
+ */
+constexpr auto segment_size = std::size_t{4096};
+
+/**
+ * Upper bound of call memory per thread. Allocating past it fails instead of
+ * growing without limit when a guest walks an unbounded parent/other chain.
+ */
+constexpr auto max_segments = std::size_t{64};
+
+/**
+ * Every allocation is aligned to (and validated in units of) a granule.
+ */
+constexpr auto granule_size = std::size_t{8};
+
+static_assert(segment_size % granule_size == 0);
+static_assert(
+	segment_size * max_segments <= std::size_t{INT32_MAX},
+	"call memory offsets must fit in a guest i32"
+);
+
+struct call_mem_stack_t {
+	std::vector<std::unique_ptr<std::byte[]>> segments;
+	std::size_t                               top = 0;
+	std::size_t                               high_water_mark = 0;
+	std::size_t                               frames_count = 0;
+
+#ifdef ECSACT_SI_WASMER_CALL_MEM_VALIDATION
+	/**
+	 * One entry per granule. The first granule of an allocation holds its type
+	 * and the rest are `nullptr`.
+	 */
+	std::vector<const std::type_info*> shadow;
+
+	std::array<const char*, 16> method_trace = {};
+	std::size_t                 method_trace_index = 0;
 #endif
 };
 
-thread_local auto call_mem_info = std::optional<call_mem_info_t>{};
-} // namespace
+thread_local auto call_mem = call_mem_stack_t{};
+
+#ifdef ECSACT_SI_WASMER_CALL_MEM_VALIDATION
+auto shadow_assign( //
+	std::size_t           offset,
+	std::size_t           size,
+	const std::type_info* type
+) -> void {
+	auto first = offset / granule_size;
+	auto last = (offset + size) / granule_size;
+	if(call_mem.shadow.size() < last) {
+		call_mem.shadow.resize(last);
+	}
 
-#ifndef NDEBUG
-#	define ASSERT_OFFSET_TYPE(offset, type)                     \
-		{                                                          \
-			auto& types = call_mem_info->data_offset_types;          \
-			assert(types.contains(offset));                          \
-			assert(std::strcmp(types.at(offset), type.name()) == 0); \
-		}                                                          \
-		static_assert(true, "macro requires semi-colon")
-#	define ASSIGN_OFFSET_TYPE(offset, type)                      \
-		assert(!call_mem_info->data_offset_types.contains(offset)); \
-		call_mem_info->data_offset_types.insert({offset, type.name()})
-#else
-#	define ASSERT_OFFSET_TYPE(offset, type) \
-		static_assert(true, "macro requires semi-colon")
-#	define ASSIGN_OFFSET_TYPE(offset, type) \
-		static_assert(true, "macro requires semi-colon")
+	call_mem.shadow[first] = type;
+	for(auto i = first + 1; last > i; ++i) {
+		call_mem.shadow[i] = nullptr;
+	}
+}
 #endif
+} // namespace
 
-auto ecsact::wasm::detail::set_call_mem_data( //
-	void*  data,
-	size_t max_size
-) -> void {
-	if(data == nullptr) {
-		call_mem_info = std::nullopt;
-		return;
+auto ecsact::wasm::detail::call_mem_push_frame() -> call_mem_frame {
+	auto frame = call_mem_frame{
+		.offset = static_cast<std::int32_t>(call_mem.top),
+		.depth = call_mem.frames_count,
+		.saved_high_water_mark = call_mem.high_water_mark,
+	};
+	call_mem.frames_count += 1;
+	call_mem.high_water_mark = call_mem.top;
+	return frame;
+}
+
+auto ecsact::wasm::detail::call_mem_pop_frame( //
+	call_mem_frame frame
+) -> std::size_t {
+	assert(frame.depth < call_mem.frames_count);
+	assert(static_cast<std::size_t>(frame.offset) <= call_mem.top);
+	call_mem.frames_count = frame.depth;
+
+	auto frame_high_water_mark =
+		call_mem.high_water_mark - static_cast<std::size_t>(frame.offset);
+	call_mem.high_water_mark =
+		std::max(call_mem.high_water_mark, frame.saved_high_water_mark);
+	call_mem.top = static_cast<std::size_t>(frame.offset);
+
+	if(call_mem.frames_count == 0) {
+		call_mem.top = 0;
+		call_mem.high_water_mark = 0;
 	}
 
-	assert(!call_mem_info.has_value());
-	auto& cmi = call_mem_info.emplace();
-	cmi.data = std::span{static_cast<std::byte*>(data), max_size};
-	cmi.data_offset = 0;
+	return frame_high_water_mark;
 }
 
 auto ecsact::wasm::detail::call_mem_alloc_raw( //
 	size_t                data_size,
 	const std::type_info& type
 ) -> std::int32_t {
-	assert(call_mem_info.has_value());
+	assert(call_mem.frames_count > 0);
 	assert(data_size > 0);
-	auto index = static_cast<std::int32_t>(call_mem_info->data_offset);
-	ASSIGN_OFFSET_TYPE(call_mem_info->data_offset, type);
-	call_mem_info->data_offset += data_size;
-	assert(index >= 0);
-	return index;
+
+	auto size = (data_size + granule_size - 1) & ~(granule_size - 1);
+	if(size > segment_size) {
+		return call_mem_invalid_offset;
+	}
+
+	auto offset = call_mem.top;
+	if(offset % segment_size + size > segment_size) {
+		// Skip the tail of the current segment
+		auto next_segment_offset = offset - offset % segment_size + segment_size;
+#ifdef ECSACT_SI_WASMER_CALL_MEM_VALIDATION
+		shadow_assign(offset, next_segment_offset - offset, nullptr);
+#endif
+		offset = next_segment_offset;
+	}
+
+	auto segment_index = offset / segment_size;
+	if(segment_index >= max_segments) {
+		return call_mem_invalid_offset;
+	}
+
+	if(segment_index == call_mem.segments.size()) {
+		call_mem.segments.emplace_back(
+			std::make_unique_for_overwrite<std::byte[]>(segment_size)
+		);
+	}
+
+#ifdef ECSACT_SI_WASMER_CALL_MEM_VALIDATION
+	shadow_assign(offset, size, &type);
+#endif
+
+	call_mem.top = offset + size;
+	call_mem.high_water_mark = std::max(call_mem.high_water_mark, call_mem.top);
+	return static_cast<std::int32_t>(offset);
 }
 
 auto ecsact::wasm::detail::call_mem_read_raw( //
-	std::int32_t          offset,
-	const std::type_info& type
+	std::int32_t                           offset,
+	size_t                                 data_size,
+	[[maybe_unused]] const std::type_info& type
 ) -> void* {
-	assert(call_mem_info.has_value());
-	assert(offset < call_mem_info->data_offset);
-	ASSERT_OFFSET_TYPE(offset, type);
-	return call_mem_info->data.data() + offset;
+	if(offset < 0) {
+		return nullptr;
+	}
+
+	auto uoffset = static_cast<std::size_t>(offset);
+	if(uoffset % granule_size != 0 || uoffset + data_size > call_mem.top ||
+		 uoffset % segment_size + data_size > segment_size) {
+		return nullptr;
+	}
+
+#ifdef ECSACT_SI_WASMER_CALL_MEM_VALIDATION
+	auto allocated_type = call_mem.shadow[uoffset / granule_size];
+	if(allocated_type == nullptr || *allocated_type != type) {
+		return nullptr;
+	}
+#endif
+
+	auto segment = call_mem.segments[uoffset / segment_size].get();
+	return segment + uoffset % segment_size;
 }
 
 auto ecsact::wasm::detail::debug_trace_method( //
 	[[maybe_unused]] const char* method_name
 ) -> void {
-#ifndef NDEBUG
-	assert(call_mem_info.has_value());
-	call_mem_info->method_trace.push_back(std::string_view{method_name});
+#ifdef ECSACT_SI_WASMER_CALL_MEM_VALIDATION
+	auto index = call_mem.method_trace_index++ % call_mem.method_trace.size();
+	call_mem.method_trace[index] = method_name;
 #endif
 }
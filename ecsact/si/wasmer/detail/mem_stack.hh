@@ -1,47 +1,90 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 #include <string_view>
 #include <type_traits>
 #include <typeinfo>
 
+/**
+ * Define `ECSACT_SI_WASMER_CALL_MEM_VALIDATION` to record the type of every
+ * call memory allocation in a shadow table and check it on every read. Always
+ * enabled in debug builds.
+ */
+#if !defined(NDEBUG) && !defined(ECSACT_SI_WASMER_CALL_MEM_VALIDATION)
+#	define ECSACT_SI_WASMER_CALL_MEM_VALIDATION
+#endif
+
 namespace ecsact::wasm::detail {
-auto set_call_mem_data( //
-	void*  data,
-	size_t max_size
-) -> void;
+
+/**
+ * Returned by `call_mem_alloc` when call memory is exhausted.
+ */
+constexpr auto call_mem_invalid_offset = std::int32_t{-1};
+
+/**
+ * Saved position of the call memory stack. See `call_mem_push_frame`.
+ */
+struct call_mem_frame {
+	std::int32_t offset;
+	std::size_t  depth;
+	std::size_t  saved_high_water_mark;
+};
+
+/**
+ * Pushes a frame on the calling thread's call memory stack. Call memory is
+ * made of fixed size segments that are kept around and reused between calls.
+ * Frames may nest, e.g. for a system impl executed while another is running
+ * on the same thread.
+ */
+auto call_mem_push_frame() -> call_mem_frame;
+
+/**
+ * Pops @p frame and every frame pushed after it. Offsets allocated since
+ * @p frame was pushed are no longer valid.
+ *
+ * @returns the most call memory (in bytes) used at once while @p frame was
+ *          pushed, including nested frames
+ */
+auto call_mem_pop_frame(call_mem_frame frame) -> std::size_t;
 
 auto debug_trace_method( //
 	const char* method_name
 ) -> void;
 
+/**
+ * @returns offset of the allocation or `call_mem_invalid_offset` if call
+ *          memory is exhausted
+ */
 auto call_mem_alloc_raw( //
 	size_t                data_size,
 	const std::type_info& type
 ) -> std::int32_t;
 
+/**
+ * @returns pointer to the allocation at @p offset or `nullptr` if @p offset
+ *          does not refer to allocated call memory. Offsets usually come from
+ *          the guest so this check is always on.
+ */
 auto call_mem_read_raw( //
 	std::int32_t          offset,
+	size_t                data_size,
 	const std::type_info& type
 ) -> void*;
 
 template<typename T>
 	requires(std::is_trivial_v<T>)
-auto call_mem_read(std::int32_t offset) -> T& {
-	return *static_cast<T*>(call_mem_read_raw(offset, typeid(T)));
+auto call_mem_read(std::int32_t offset) -> T* {
+	return static_cast<T*>(call_mem_read_raw(offset, sizeof(T), typeid(T)));
 }
 
 template<typename T>
 	requires(std::is_trivial_v<T>)
 auto call_mem_alloc(T value) -> std::int32_t {
 	auto offset = call_mem_alloc_raw(sizeof(T), typeid(T));
-	call_mem_read<T>(offset) = value;
+	if(offset != call_mem_invalid_offset) {
+		*call_mem_read<T>(offset) = value;
+	}
 	return offset;
 }
-
-template<typename T>
-	requires(std::is_trivial_v<T>)
-auto call_mem_replace(std::int32_t offset, T value) -> void {
-	call_mem_read<T>(offset, typeid(T)) = value;
-}
 } // namespace ecsact::wasm::detail
@@ -10,6 +10,7 @@ using ecsact::wasm::detail::minst;
 using ecsact::wasm::detail::minst_export;
 using ecsact::wasm::detail::minst_import;
 using ecsact::wasm::detail::minst_import_resolve_func;
+using ecsact::wasm::detail::minst_import_resolve_func_with_env;
 using ecsact::wasm::detail::minst_trap;
 
 namespace {
@@ -108,6 +109,14 @@ auto minst_import_resolve_func::as_extern( //
 	return wasm_func_as_extern(func);
 }
 
+auto minst_import_resolve_func_with_env::as_extern( //
+	wasm_store_t* store
+) -> wasm_extern_t* {
+	auto func =
+		wasm_func_new_with_env(store, func_type, func_callback, env, nullptr);
+	return wasm_func_as_extern(func);
+}
+
 auto minst_trap::message() const -> std::string {
 	auto trap_msg = wasm_message_t{};
 	wasm_trap_message(trap, &trap_msg);
@@ -254,6 +263,10 @@ minst::~minst() {
 	}
 }
 
+auto minst::store() -> wasm_store_t* {
+	return _store;
+}
+
 auto minst::imports() -> std::span<minst_import> {
 	return std::span{_imports.data(), _imports.size()};
 }
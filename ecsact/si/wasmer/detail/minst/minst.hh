@@ -44,8 +44,20 @@ struct minst_import_resolve_func {
 	auto as_extern(wasm_store_t* store) -> wasm_extern_t*;
 };
 
-using minst_import_resolve_t =
-	std::optional<std::variant<minst_import_resolve_func>>;
+/**
+ * Same as `minst_import_resolve_func` except @p env is passed as the first
+ * argument to @p func_callback on every call.
+ */
+struct minst_import_resolve_func_with_env {
+	wasm_functype_t*              func_type;
+	wasm_func_callback_with_env_t func_callback;
+	void*                         env = nullptr;
+
+	auto as_extern(wasm_store_t* store) -> wasm_extern_t*;
+};
+
+using minst_import_resolve_t = std::optional<
+	std::variant<minst_import_resolve_func, minst_import_resolve_func_with_env>>;
 
 struct minst_import {
 	wasm_importtype_t* import_type;
@@ -89,6 +101,7 @@ public:
 	minst(minst&& other);
 	~minst();
 
+	auto store() -> wasm_store_t*;
 	auto imports() -> std::span<minst_import>;
 	auto exports() -> std::span<minst_export>;
 
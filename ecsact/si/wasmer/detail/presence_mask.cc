@@ -0,0 +1,24 @@
+#include "ecsact/si/wasmer/detail/presence_mask.hh"
+
+#include <cstring>
+#include "ecsact/runtime/dynamic.h"
+#include "ecsact/si/wasmer/detail/instance_env.hh"
+
+auto ecsact::wasm::detail::populate_presence_mask(
+	instance_env&                    env,
+	const presence_mask&             mask,
+	ecsact_system_execution_context* ctx
+) -> void {
+	auto mask_data = env.registered_region(mask.guest_ptr, sizeof(uint64_t));
+
+	auto bits = std::uint64_t{};
+	for(auto i = std::size_t{}; mask.component_ids.size() > i; ++i) {
+		auto component_id = mask.component_ids[i];
+		if(ecsact_system_execution_context_has(ctx, component_id, nullptr)) {
+			bits |= std::uint64_t{1} << i;
+		}
+	}
+
+	// Guest pointer may not be 8 byte aligned
+	std::memcpy(mask_data, &bits, sizeof(bits));
+}
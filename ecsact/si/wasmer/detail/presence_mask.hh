@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "ecsact/runtime/common.h"
+
+namespace ecsact::wasm::detail {
+
+struct instance_env;
+
+/**
+ * Guest memory `u64` registered by the guest (see
+ * `ecsact_si_wasm_register_presence_mask`) that the host sets before every
+ * system impl call. Bit N is set when the entity has `component_ids[N]`.
+ * Guests test bits instead of calling `ecsact_system_execution_context_has`
+ * for the optional and checked components of the system.
+ */
+struct presence_mask {
+	static constexpr std::size_t max_components = 64;
+
+	std::int32_t                          guest_ptr = 0;
+	std::vector<ecsact_component_like_id> component_ids;
+};
+
+/**
+ * Computes the presence bits of @p ctx and writes them to @p mask.
+ */
+auto populate_presence_mask(
+	instance_env&                    env,
+	const presence_mask&             mask,
+	ecsact_system_execution_context* ctx
+) -> void;
+
+} // namespace ecsact::wasm::detail
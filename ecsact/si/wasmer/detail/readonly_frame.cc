@@ -0,0 +1,39 @@
+#include "ecsact/si/wasmer/detail/readonly_frame.hh"
+
+#include <cstring>
+#include "ecsact/runtime/dynamic.h"
+#include "ecsact/si/wasmer/detail/instance_env.hh"
+
+auto ecsact::wasm::detail::populate_readonly_frame(
+	instance_env&                    env,
+	const readonly_frame&            frame,
+	ecsact_system_execution_context* ctx
+) -> void {
+	auto frame_data = env.registered_region(frame.guest_ptr, frame.size);
+
+	auto entity = static_cast<std::int32_t>( //
+		ecsact_system_execution_context_entity(ctx)
+	);
+	std::memcpy(
+		frame_data + readonly_frame::entity_offset,
+		&entity,
+		sizeof(entity)
+	);
+
+	auto has_flags = frame_data + readonly_frame::has_offset;
+	for(auto i = std::size_t{}; frame.component_ids.size() > i; ++i) {
+		auto component_id = frame.component_ids[i];
+		auto has_component =
+			ecsact_system_execution_context_has(ctx, component_id, nullptr);
+
+		has_flags[i] = std::byte{has_component};
+		if(has_component) {
+			ecsact_system_execution_context_get(
+				ctx,
+				component_id,
+				frame_data + frame.component_offsets[i],
+				nullptr
+			);
+		}
+	}
+}
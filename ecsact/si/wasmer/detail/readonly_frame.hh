@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "ecsact/runtime/common.h"
+
+namespace ecsact::wasm::detail {
+
+struct instance_env;
+
+/**
+ * Guest memory region registered by the guest (see
+ * `ecsact_si_wasm_register_readonly_frame`) that the host fills with the
+ * entity and its readable components before every system impl call. Guests
+ * read from the frame instead of calling `get`, `has` and `entity`.
+ *
+ * Frame layout in guest memory:
+ *   offset 0                 i32 entity id
+ *   offset 4                 u8[components_count] has flags
+ *   component_offsets[N]     component N data
+ */
+struct readonly_frame {
+	static constexpr std::int32_t entity_offset = 0;
+	static constexpr std::int32_t has_offset = 4;
+
+	std::int32_t                          guest_ptr = 0;
+	std::size_t                           size = 0;
+	std::vector<ecsact_component_like_id> component_ids;
+	std::vector<std::int32_t>             component_offsets;
+};
+
+/**
+ * Copies the entity and readable components of @p ctx into @p frame.
+ */
+auto populate_readonly_frame(
+	instance_env&                    env,
+	const readonly_frame&            frame,
+	ecsact_system_execution_context* ctx
+) -> void;
+
+} // namespace ecsact::wasm::detail
@@ -0,0 +1,209 @@
+#include "ecsact/si/wasmer/detail/schema.hh"
+
+#include <algorithm>
+#include <vector>
+#include "ecsact/runtime/meta.h"
+
+namespace {
+
+struct field_layout {
+	std::size_t size = 0;
+	std::size_t alignment = 1;
+};
+
+auto builtin_size(ecsact_builtin_type type) -> std::optional<std::size_t> {
+	switch(type) {
+		case ECSACT_BOOL:
+		case ECSACT_I8:
+		case ECSACT_U8:
+			return 1;
+		case ECSACT_I16:
+		case ECSACT_U16:
+			return 2;
+		case ECSACT_I32:
+		case ECSACT_U32:
+		case ECSACT_F32:
+		case ECSACT_ENTITY_TYPE:
+			return 4;
+	}
+	return std::nullopt;
+}
+
+auto element_size(ecsact_field_type type) -> std::optional<std::size_t> {
+	switch(type.kind) {
+		case ECSACT_TYPE_KIND_BUILTIN:
+			return builtin_size(type.type.builtin);
+		case ECSACT_TYPE_KIND_ENUM:
+			return builtin_size(ecsact_meta_enum_storage_type(type.type.enum_id));
+		case ECSACT_TYPE_KIND_FIELD_INDEX: {
+			// Field indices are stored as the value type of the indexed field
+			auto indexed_type = ecsact_meta_field_type(
+				type.type.field_index.composite_id,
+				type.type.field_index.field_id
+			);
+			if(indexed_type.kind == ECSACT_TYPE_KIND_FIELD_INDEX) {
+				return std::nullopt;
+			}
+			return element_size(indexed_type);
+		}
+	}
+	return std::nullopt;
+}
+
+auto layout_of(ecsact_field_type type) -> std::optional<field_layout> {
+	auto size = element_size(type);
+	if(!size) {
+		return std::nullopt;
+	}
+
+	// Scalars and arrays are both aligned to their element
+	return field_layout{
+		.size = *size * static_cast<std::size_t>(std::max(type.length, 1)),
+		.alignment = *size,
+	};
+}
+
+auto align_up(std::size_t offset, std::size_t alignment) -> std::size_t {
+	return (offset + alignment - 1) / alignment * alignment;
+}
+
+/**
+ * Only scalar integer fields (entities, integers, enums and indices of those)
+ * can be matched exactly, so only they can be indexed
+ */
+auto is_indexable(ecsact_field_type type) -> bool {
+	if(type.length > 1) {
+		return false;
+	}
+
+	switch(type.kind) {
+		case ECSACT_TYPE_KIND_BUILTIN:
+			return type.type.builtin != ECSACT_BOOL &&
+				type.type.builtin != ECSACT_F32;
+		case ECSACT_TYPE_KIND_ENUM:
+		case ECSACT_TYPE_KIND_FIELD_INDEX:
+			return true;
+	}
+	return false;
+}
+
+/**
+ * Size of a C struct with the fields of @p component_id that pass @p filter
+ * in order
+ */
+template<typename Filter>
+auto struct_size( //
+	ecsact_component_like_id component_id,
+	Filter&&                 filter
+) -> std::optional<std::size_t> {
+#ifdef ECSACT_META_API_LOAD_AT_RUNTIME
+	if(ecsact_meta_count_fields == nullptr ||
+		 ecsact_meta_get_field_ids == nullptr ||
+		 ecsact_meta_field_type == nullptr ||
+		 ecsact_meta_enum_storage_type == nullptr) {
+		return std::nullopt;
+	}
+#endif
+
+	auto composite_id = ecsact_id_cast<ecsact_composite_id>(component_id);
+	auto fields_count = ecsact_meta_count_fields(composite_id);
+	if(fields_count <= 0) {
+		return std::size_t{0};
+	}
+
+	auto field_ids = std::vector<ecsact_field_id>(fields_count);
+	ecsact_meta_get_field_ids(
+		composite_id,
+		fields_count,
+		field_ids.data(),
+		&fields_count
+	);
+	field_ids.resize(std::min(
+		field_ids.size(),
+		static_cast<std::size_t>(std::max(fields_count, 0))
+	));
+
+	auto size = std::size_t{};
+	auto alignment = std::size_t{1};
+	for(auto field_id : field_ids) {
+		auto type = ecsact_meta_field_type(composite_id, field_id);
+		if(!filter(type)) {
+			continue;
+		}
+
+		auto layout = layout_of(type);
+		if(!layout) {
+			return std::nullopt;
+		}
+
+		size = align_up(size, layout->alignment) + layout->size;
+		alignment = std::max(alignment, layout->alignment);
+	}
+
+	return align_up(size, alignment);
+}
+
+} // namespace
+
+auto ecsact::wasm::detail::component_data_size( //
+	ecsact_component_like_id component_id
+) -> std::optional<std::size_t> {
+	return struct_size(component_id, [](ecsact_field_type) { return true; });
+}
+
+auto ecsact::wasm::detail::indexed_field_values_size( //
+	ecsact_component_like_id component_id
+) -> std::optional<std::size_t> {
+	return struct_size(component_id, is_indexable);
+}
+
+auto ecsact::wasm::detail::system_capabilities( //
+	ecsact_system_like_id system_id
+) -> std::optional<std::vector<component_capability>> {
+#ifdef ECSACT_META_API_LOAD_AT_RUNTIME
+	if(ecsact_meta_system_capabilities_count == nullptr ||
+		 ecsact_meta_system_capabilities == nullptr) {
+		return std::nullopt;
+	}
+#endif
+
+	auto capabilities_count = ecsact_meta_system_capabilities_count(system_id);
+	if(capabilities_count <= 0) {
+		return std::vector<component_capability>{};
+	}
+
+	auto component_ids =
+		std::vector<ecsact_component_like_id>(capabilities_count);
+	auto capabilities = std::vector<ecsact_system_capability>(capabilities_count);
+	ecsact_meta_system_capabilities(
+		system_id,
+		component_ids.data(),
+		capabilities.data()
+	);
+
+	auto result = std::vector<component_capability>{};
+	result.reserve(capabilities_count);
+	for(auto i = 0; capabilities_count > i; ++i) {
+		result.push_back({component_ids[i], capabilities[i]});
+	}
+
+	return result;
+}
+
+auto ecsact::wasm::detail::system_capability(
+	ecsact_system_like_id    system_id,
+	ecsact_component_like_id component_id
+) -> std::optional<ecsact_system_capability> {
+	auto capabilities = system_capabilities(system_id);
+	if(!capabilities) {
+		return std::nullopt;
+	}
+
+	for(auto& entry : *capabilities) {
+		if(entry.component_id == component_id) {
+			return entry.capability;
+		}
+	}
+
+	return std::nullopt;
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstddef>
+#include <optional>
+#include <vector>
+#include "ecsact/runtime/common.h"
+
+namespace ecsact::wasm::detail {
+
+/**
+ * Size in bytes of the component struct the ecsact C codegen emits for
+ * @p component_id, derived from the field types in the ecsact meta module.
+ * The runtime reads or writes this many bytes behind every component data
+ * pointer a guest hands to it.
+ * @returns `std::nullopt` if the meta module does not know a field type
+ */
+auto component_data_size( //
+	ecsact_component_like_id component_id
+) -> std::optional<std::size_t>;
+
+/**
+ * Size in bytes of the indexed field values the runtime reads for
+ * @p component_id. Laid out like a C struct of the component's scalar integer
+ * fields in order, the only fields that can be indexed.
+ * @returns `std::nullopt` if the meta module does not know a field type
+ */
+auto indexed_field_values_size( //
+	ecsact_component_like_id component_id
+) -> std::optional<std::size_t>;
+
+struct component_capability {
+	ecsact_component_like_id component_id;
+	ecsact_system_capability capability;
+};
+
+/**
+ * Every capability @p system_id declares in the ecsact meta module.
+ * @returns `std::nullopt` if the meta module is not loaded
+ */
+auto system_capabilities( //
+	ecsact_system_like_id system_id
+) -> std::optional<std::vector<component_capability>>;
+
+/**
+ * Capability @p system_id declares for @p component_id in the ecsact meta
+ * module.
+ * @returns `std::nullopt` if the system declares no capability for the
+ *          component
+ */
+auto system_capability(
+	ecsact_system_like_id    system_id,
+	ecsact_component_like_id component_id
+) -> std::optional<ecsact_system_capability>;
+
+} // namespace ecsact::wasm::detail
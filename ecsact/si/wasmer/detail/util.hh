@@ -32,12 +32,68 @@ inline wasm_functype_t* wasm_functype_new_4_1(
 	return wasm_functype_new(&params, &results);
 }
 
-template<typename T>
-auto wasm_memory_cast( //
-	wasm_memory_t* wasm_mem,
-	int32_t        wasm_guest_ptr
-) -> T* {
-	auto mem_bytes = wasm_memory_data(wasm_mem);
-	return reinterpret_cast<T*>(mem_bytes + wasm_guest_ptr);
+inline wasm_functype_t* wasm_functype_new_5_0(
+	wasm_valtype_t* p1,
+	wasm_valtype_t* p2,
+	wasm_valtype_t* p3,
+	wasm_valtype_t* p4,
+	wasm_valtype_t* p5
+) {
+	wasm_valtype_t*    ps[5] = {p1, p2, p3, p4, p5};
+	wasm_valtype_vec_t params, results;
+	wasm_valtype_vec_new(&params, 5, ps);
+	wasm_valtype_vec_new_empty(&results);
+	return wasm_functype_new(&params, &results);
+}
+
+inline wasm_functype_t* wasm_functype_new_5_1(
+	wasm_valtype_t* p1,
+	wasm_valtype_t* p2,
+	wasm_valtype_t* p3,
+	wasm_valtype_t* p4,
+	wasm_valtype_t* p5,
+	wasm_valtype_t* r
+) {
+	wasm_valtype_t*    rs[1] = {r};
+	wasm_valtype_t*    ps[5] = {p1, p2, p3, p4, p5};
+	wasm_valtype_vec_t params, results;
+	wasm_valtype_vec_new(&params, 5, ps);
+	wasm_valtype_vec_new(&results, 1, rs);
+	return wasm_functype_new(&params, &results);
+}
+
+inline wasm_functype_t* wasm_functype_new_6_0(
+	wasm_valtype_t* p1,
+	wasm_valtype_t* p2,
+	wasm_valtype_t* p3,
+	wasm_valtype_t* p4,
+	wasm_valtype_t* p5,
+	wasm_valtype_t* p6
+) {
+	wasm_valtype_t*    ps[6] = {p1, p2, p3, p4, p5, p6};
+	wasm_valtype_vec_t params, results;
+	wasm_valtype_vec_new(&params, 6, ps);
+	wasm_valtype_vec_new_empty(&results);
+	return wasm_functype_new(&params, &results);
+}
+
+inline wasm_functype_t* wasm_functype_new_9_1(
+	wasm_valtype_t* p1,
+	wasm_valtype_t* p2,
+	wasm_valtype_t* p3,
+	wasm_valtype_t* p4,
+	wasm_valtype_t* p5,
+	wasm_valtype_t* p6,
+	wasm_valtype_t* p7,
+	wasm_valtype_t* p8,
+	wasm_valtype_t* p9,
+	wasm_valtype_t* r
+) {
+	wasm_valtype_t*    rs[1] = {r};
+	wasm_valtype_t*    ps[9] = {p1, p2, p3, p4, p5, p6, p7, p8, p9};
+	wasm_valtype_vec_t params, results;
+	wasm_valtype_vec_new(&params, 9, ps);
+	wasm_valtype_vec_new(&results, 1, rs);
+	return wasm_functype_new(&params, &results);
 }
 } // namespace ecsact::wasm::detail
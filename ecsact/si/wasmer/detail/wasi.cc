@@ -1,22 +1,31 @@
 #include "ecsact/si/wasmer/detail/wasi.hh"
 
+#include <algorithm>
+#include <cstddef>
 #include <cstdio>
 #include <map>
+#include <span>
+#include <string>
 #include <string_view>
 #include "ecsact/si/wasmer/detail/wasi_fs.hh"
+#include "ecsact/si/wasmer/detail/wasi_clock.hh"
 #include "ecsact/si/wasmer/detail/logger.hh"
+#include "ecsact/si/wasmer/detail/log_file_sink.hh"
+#include "ecsact/si/wasmer/detail/log_rate_limit.hh"
 #include "ecsact/si/wasmer/detail/mem_stack.hh"
 #include "ecsact/si/wasmer/detail/util.hh"
+#include "ecsact/si/wasmer/detail/instance_env.hh"
 
-using ecsact::wasm::detail::call_mem_read;
 using ecsact::wasm::detail::debug_trace_method;
-using ecsact::wasm::detail::wasm_memory_cast;
+using ecsact::wasm::detail::get_instance_env;
+using ecsact::wasm::detail::instance_env;
 
 constexpr int32_t WASI_STDIN_FD = 0;
 constexpr int32_t WASI_STDOUT_FD = 1;
 constexpr int32_t WASI_STDERR_FD = 2;
 
 wasm_trap_t* ecsact_si_wasi_proc_exit(
+	void*                 env,
 	const wasm_val_vec_t* args,
 	wasm_val_vec_t*       results
 ) {
@@ -24,50 +33,161 @@ wasm_trap_t* ecsact_si_wasi_proc_exit(
 	return nullptr;
 }
 
+static auto is_stdio_fd(int32_t fd) -> bool {
+	return fd == WASI_STDIN_FD || fd == WASI_STDOUT_FD || fd == WASI_STDERR_FD;
+}
+
 wasm_trap_t* ecsact_si_wasi_fd_seek(
+	void*                 env,
 	const wasm_val_vec_t* args,
 	wasm_val_vec_t*       results
 ) {
 	debug_trace_method("fd_seek");
+	auto& inst_env = get_instance_env(env);
+
+	assert(args->data[0].kind == WASM_I32);
+	auto fd = args->data[0].of.i32;
+
+	assert(args->data[1].kind == WASM_I64);
+	auto offset = args->data[1].of.i64;
+
+	assert(args->data[2].kind == WASM_I32);
+	auto whence_value = args->data[2].of.i32;
+
+	assert(args->data[3].kind == WASM_I32);
+	auto out_new_offset = inst_env.guest_cast<uint64_t>(args->data[3].of.i32);
+
+	if(!out_new_offset) {
+		return inst_env.out_of_bounds_trap("fd_seek");
+	}
+
+	auto err = ecsact_si_wasi_errno::spipe;
+
+	// Checked before the cast since `ecsact_si_wasi_whence` is only 8 bits
+	if(whence_value < static_cast<int32_t>(ecsact_si_wasi_whence::set) ||
+		 whence_value > static_cast<int32_t>(ecsact_si_wasi_whence::end)) {
+		err = ecsact_si_wasi_errno::inval;
+	} else if(!is_stdio_fd(fd)) {
+		err = ecsact::wasm::detail::wasi::fs::seek(
+			inst_env.fd_table,
+			fd,
+			offset,
+			static_cast<ecsact_si_wasi_whence>(whence_value),
+			*out_new_offset
+		);
+	}
+
 	results->data[0].kind = WASM_I32;
-	results->data[0].of.i32 = 0;
+	results->data[0].of.i32 = static_cast<int32_t>(err);
 
 	return nullptr;
 }
 
-wasm_trap_t* ecsact_si_wasi_fd_write(
+wasm_trap_t* ecsact_si_wasi_fd_tell(
+	void*                 env,
 	const wasm_val_vec_t* args,
 	wasm_val_vec_t*       results
 ) {
-	debug_trace_method("fd_write");
-	auto mem = call_mem_read<wasm_memory_t*>(0);
+	debug_trace_method("fd_tell");
+	auto& inst_env = get_instance_env(env);
+
 	assert(args->data[0].kind == WASM_I32);
 	auto fd = args->data[0].of.i32;
 
 	assert(args->data[1].kind == WASM_I32);
-	auto iovec =
-		wasm_memory_cast<ecsact_si_wasi_ciovec_t>(mem, args->data[1].of.i32);
+	auto out_offset = inst_env.guest_cast<uint64_t>(args->data[1].of.i32);
+
+	if(!out_offset) {
+		return inst_env.out_of_bounds_trap("fd_tell");
+	}
+
+	auto err = ecsact_si_wasi_errno::spipe;
+	if(!is_stdio_fd(fd)) {
+		auto offset =
+			ecsact::wasm::detail::wasi::fs::tell(inst_env.fd_table, fd);
+		if(offset) {
+			*out_offset = *offset;
+			err = ecsact_si_wasi_errno::success;
+		} else {
+			err = ecsact_si_wasi_errno::badf;
+		}
+	}
+
+	results->data[0].kind = WASM_I32;
+	results->data[0].of.i32 = static_cast<int32_t>(err);
+
+	return nullptr;
+}
+
+wasm_trap_t* ecsact_si_wasi_fd_write(
+	void*                 env,
+	const wasm_val_vec_t* args,
+	wasm_val_vec_t*       results
+) {
+	debug_trace_method("fd_write");
+	auto& inst_env = get_instance_env(env);
+	assert(args->data[0].kind == WASM_I32);
+	auto fd = args->data[0].of.i32;
 
 	assert(args->data[2].kind == WASM_I32);
 	auto iovec_len = args->data[2].of.i32;
 
+	assert(args->data[1].kind == WASM_I32);
+	auto iovec = inst_env.guest_cast<const ecsact_si_wasi_ciovec_t>(
+		args->data[1].of.i32,
+		iovec_len
+	);
+
 	assert(args->data[3].kind == WASM_I32);
-	auto out_write_amount = wasm_memory_cast<size_t>(mem, args->data[3].of.i32);
+	auto out_write_amount = inst_env.guest_cast<uint32_t>(args->data[3].of.i32);
+
+	if(iovec_len < 0 || !iovec || !out_write_amount) {
+		return inst_env.out_of_bounds_trap("fd_write");
+	}
 
 	if(fd == WASI_STDERR_FD || fd == WASI_STDOUT_FD) {
-		auto write_amount = size_t{};
+		auto write_amount = uint32_t{};
 		auto log_level = fd == WASI_STDOUT_FD //
 			? ECSACT_SI_WASM_LOG_LEVEL_INFO
 			: ECSACT_SI_WASM_LOG_LEVEL_ERROR;
+		auto attribution = ecsact::wasm::detail::log_attribution{
+			.system_id = inst_env.current_system_id,
+			.entity = inst_env.current_entity,
+			.instance_index = inst_env.index,
+		};
+		auto file_sink = ecsact::wasm::detail::active_log_file_sink();
 
 		for(int i = 0; iovec_len > i; ++i) {
 			auto io = iovec[i];
 
 			if(io.buf_len > 0) {
-				auto buf = wasm_memory_cast<const char>(mem, io.buf);
+				auto buf = inst_env.guest_cast<const char>(io.buf, io.buf_len);
+				if(!buf) {
+					return inst_env.out_of_bounds_trap("fd_write");
+				}
 				auto str = std::string_view(buf, io.buf_len);
 				write_amount += io.buf_len;
-				ecsact::wasm::detail::push_stdio_str(log_level, str);
+
+				inst_env.log_admission.feed(
+					attribution.system_id,
+					log_level,
+					str,
+					[&](std::string_view admitted_str) {
+						if(file_sink) {
+							file_sink->write(
+								log_level,
+								ecsact::wasm::detail::stamp_log_attribution(attribution),
+								admitted_str
+							);
+						} else {
+							ecsact::wasm::detail::push_stdio_str(
+								log_level,
+								attribution,
+								admitted_str
+							);
+						}
+					}
+				);
 			}
 		}
 
@@ -76,62 +196,185 @@ wasm_trap_t* ecsact_si_wasi_fd_write(
 		results->data[0].kind = WASM_I32;
 		results->data[0].of.i32 = 0;
 	} else {
+		auto write_amount = uint32_t{};
+		auto err = ecsact_si_wasi_errno::success;
+
+		for(int i = 0; iovec_len > i; ++i) {
+			auto io = iovec[i];
+
+			if(io.buf_len > 0) {
+				auto buf = inst_env.guest_cast<const std::byte>(io.buf, io.buf_len);
+				if(!buf) {
+					return inst_env.out_of_bounds_trap("fd_write");
+				}
+
+				auto written = ecsact::wasm::detail::wasi::fs::write(
+					inst_env.fd_table,
+					fd,
+					std::span{buf, static_cast<std::size_t>(io.buf_len)}
+				);
+				if(!written) {
+					err = ecsact_si_wasi_errno::badf;
+					break;
+				}
+
+				write_amount += io.buf_len;
+			}
+		}
+
+		*out_write_amount = write_amount;
+
 		results->data[0].kind = WASM_I32;
-		results->data[0].of.i32 = 1;
+		results->data[0].of.i32 = static_cast<int32_t>(err);
 	}
 
 	return nullptr;
 }
 
 wasm_trap_t* ecsact_si_wasi_fd_read(
+	void*                 env,
 	const wasm_val_vec_t* args,
 	wasm_val_vec_t*       results
 ) {
 	debug_trace_method("fd_read");
-	auto mem = call_mem_read<wasm_memory_t*>(0);
+	auto& inst_env = get_instance_env(env);
 	assert(args->data[0].kind == WASM_I32);
 	auto fd = args->data[0].of.i32;
 
-	assert(args->data[1].kind == WASM_I32);
-	auto iovec =
-		wasm_memory_cast<ecsact_si_wasi_ciovec_t>(mem, args->data[1].of.i32);
-
 	assert(args->data[2].kind == WASM_I32);
 	auto iovec_len = args->data[2].of.i32;
 
+	assert(args->data[1].kind == WASM_I32);
+	auto iovec = inst_env.guest_cast<const ecsact_si_wasi_ciovec_t>(
+		args->data[1].of.i32,
+		iovec_len
+	);
+
 	assert(args->data[3].kind == WASM_I32);
-	auto out_read_amount = wasm_memory_cast<size_t>(mem, args->data[3].of.i32);
+	auto out_read_amount = inst_env.guest_cast<uint32_t>(args->data[3].of.i32);
+
+	if(iovec_len < 0 || !iovec || !out_read_amount) {
+		return inst_env.out_of_bounds_trap("fd_read");
+	}
 
-	auto f = ecsact::wasm::detail::wasi::fs::ensure_open(fd);
-	auto read_amount = size_t{};
+	auto read_amount = uint32_t{};
+	auto err = ecsact_si_wasi_errno::success;
 
 	for(int i = 0; iovec_len > i; ++i) {
 		auto io = iovec[i];
 
 		if(io.buf_len > 0) {
-			auto buf = wasm_memory_cast<char>(mem, io.buf);
-			read_amount += std::fread(buf, 1, io.buf_len, f);
+			auto buf = inst_env.guest_cast<std::byte>(io.buf, io.buf_len);
+			if(!buf) {
+				return inst_env.out_of_bounds_trap("fd_read");
+			}
+
+			auto amount = ecsact::wasm::detail::wasi::fs::read(
+				inst_env.fd_table,
+				fd,
+				std::span{buf, static_cast<std::size_t>(io.buf_len)}
+			);
+			if(!amount) {
+				err = ecsact_si_wasi_errno::badf;
+				break;
+			}
+
+			read_amount += static_cast<uint32_t>(*amount);
+			if(*amount < static_cast<std::size_t>(io.buf_len)) {
+				break;
+			}
 		}
 	}
 
 	*out_read_amount = read_amount;
 
 	results->data[0].kind = WASM_I32;
-	results->data[0].of.i32 = 0;
+	results->data[0].of.i32 = static_cast<int32_t>(err);
+
+	return nullptr;
+}
+
+wasm_trap_t* ecsact_si_wasi_fd_pread(
+	void*                 env,
+	const wasm_val_vec_t* args,
+	wasm_val_vec_t*       results
+) {
+	debug_trace_method("fd_pread");
+	auto& inst_env = get_instance_env(env);
+	assert(args->data[0].kind == WASM_I32);
+	auto fd = args->data[0].of.i32;
+
+	assert(args->data[2].kind == WASM_I32);
+	auto iovec_len = args->data[2].of.i32;
+
+	assert(args->data[1].kind == WASM_I32);
+	auto iovec = inst_env.guest_cast<const ecsact_si_wasi_ciovec_t>(
+		args->data[1].of.i32,
+		iovec_len
+	);
+
+	assert(args->data[3].kind == WASM_I64);
+	auto offset = static_cast<uint64_t>(args->data[3].of.i64);
+
+	assert(args->data[4].kind == WASM_I32);
+	auto out_read_amount = inst_env.guest_cast<uint32_t>(args->data[4].of.i32);
+
+	if(iovec_len < 0 || !iovec || !out_read_amount) {
+		return inst_env.out_of_bounds_trap("fd_pread");
+	}
+
+	auto read_amount = uint32_t{};
+	auto err = is_stdio_fd(fd) //
+		? ecsact_si_wasi_errno::spipe
+		: ecsact_si_wasi_errno::success;
+
+	for(int i = 0; err == ecsact_si_wasi_errno::success && iovec_len > i; ++i) {
+		auto io = iovec[i];
+
+		if(io.buf_len > 0) {
+			auto buf = inst_env.guest_cast<std::byte>(io.buf, io.buf_len);
+			if(!buf) {
+				return inst_env.out_of_bounds_trap("fd_pread");
+			}
+
+			auto amount = ecsact::wasm::detail::wasi::fs::pread(
+				inst_env.fd_table,
+				fd,
+				std::span{buf, static_cast<std::size_t>(io.buf_len)},
+				offset + read_amount
+			);
+			if(!amount) {
+				err = ecsact_si_wasi_errno::badf;
+				break;
+			}
+
+			read_amount += static_cast<uint32_t>(*amount);
+			if(*amount < static_cast<std::size_t>(io.buf_len)) {
+				break;
+			}
+		}
+	}
+
+	*out_read_amount = read_amount;
+
+	results->data[0].kind = WASM_I32;
+	results->data[0].of.i32 = static_cast<int32_t>(err);
 
 	return nullptr;
 }
 
 wasm_trap_t* ecsact_si_wasi_fd_close(
+	void*                 env,
 	const wasm_val_vec_t* args,
 	wasm_val_vec_t*       results
 ) {
 	debug_trace_method("fd_close");
+	auto& inst_env = get_instance_env(env);
 	assert(args->data[0].kind == WASM_I32);
 	auto fd = args->data[0].of.i32;
 
 	if(fd != WASI_STDOUT_FD && fd != WASI_STDERR_FD && fd != WASI_STDIN_FD) {
-		ecsact::wasm::detail::wasi::fs::close(fd);
+		ecsact::wasm::detail::wasi::fs::close(inst_env.fd_table, fd);
 		results->data[0].kind = WASM_I32;
 		results->data[0].of.i32 = 0;
 	} else {
@@ -143,16 +386,22 @@ wasm_trap_t* ecsact_si_wasi_fd_close(
 }
 
 wasm_trap_t* ecsact_si_wasi_environ_sizes_get(
+	void*                 env,
 	const wasm_val_vec_t* args,
 	wasm_val_vec_t*       results
 ) {
 	debug_trace_method("environ_sizes_get");
-	auto mem = call_mem_read<wasm_memory_t*>(0);
-	auto retptr0 = wasm_memory_cast<size_t>(mem, args->data[0].of.i32);
-	auto retptr1 = wasm_memory_cast<size_t>(mem, args->data[1].of.i32);
+	auto& inst_env = get_instance_env(env);
+	auto  retptr0 = inst_env.guest_cast<uint32_t>(args->data[0].of.i32);
+	auto  retptr1 = inst_env.guest_cast<uint32_t>(args->data[1].of.i32);
+
+	if(!retptr0 || !retptr1) {
+		return inst_env.out_of_bounds_trap("environ_sizes_get");
+	}
 
-	*retptr0 = 0;
-	*retptr1 = 0;
+	auto& environment = inst_env.ensure_environment();
+	*retptr0 = static_cast<uint32_t>(environment.offsets.size());
+	*retptr1 = static_cast<uint32_t>(environment.buffer.size());
 
 	results->data[0].kind = WASM_I32;
 	results->data[0].of.i32 = 0;
@@ -161,18 +410,32 @@ wasm_trap_t* ecsact_si_wasi_environ_sizes_get(
 }
 
 wasm_trap_t* ecsact_si_wasi_environ_get(
+	void*                 env,
 	const wasm_val_vec_t* args,
 	wasm_val_vec_t*       results
 ) {
 	debug_trace_method("environ_get");
-	auto mem = call_mem_read<wasm_memory_t*>(0);
-	auto environ_arg = wasm_memory_cast<uint8_t>(mem, args->data[0].of.i32);
-	auto environ_buf_arg = wasm_memory_cast<uint8_t>(mem, args->data[1].of.i32);
+	auto& inst_env = get_instance_env(env);
+	auto& environment = inst_env.ensure_environment();
+	auto  environ_buf_ptr = static_cast<uint32_t>(args->data[1].of.i32);
+	auto  environ_arg = inst_env.guest_cast<uint32_t>(
+		args->data[0].of.i32,
+		environment.offsets.size()
+	);
+	auto environ_buf_arg = inst_env.guest_cast<char>(
+		args->data[1].of.i32,
+		environment.buffer.size()
+	);
+
+	if(!environ_arg || !environ_buf_arg) {
+		return inst_env.out_of_bounds_trap("environ_get");
+	}
 
-	// Even though our environment variable size is `0` the API expects the key
-	// values pairs to be null terminated.
-	environ_arg[0] = '\0';
-	environ_buf_arg[0] = '\0';
+	// The block is laid out once, only the pointers depend on the guest buffer
+	environment.buffer.copy(environ_buf_arg, environment.buffer.size());
+	for(auto i = std::size_t{}; environment.offsets.size() > i; ++i) {
+		environ_arg[i] = environ_buf_ptr + environment.offsets[i];
+	}
 
 	results->data[0].kind = WASM_I32;
 	results->data[0].of.i32 = 0;
@@ -181,6 +444,7 @@ wasm_trap_t* ecsact_si_wasi_environ_get(
 }
 
 wasm_trap_t* ecsact_si_wasi_fd_fdstat_get(
+	void*                 env,
 	const wasm_val_vec_t* args,
 	wasm_val_vec_t*       results
 ) {
@@ -218,19 +482,22 @@ wasm_trap_t* ecsact_si_wasi_fd_fdstat_get(
 		},
 	};
 
-	auto mem = call_mem_read<wasm_memory_t*>(0);
+	auto& inst_env = get_instance_env(env);
 
 	assert(args->data[0].kind == WASM_I32);
 	auto fd = args->data[0].of.i32;
 
 	assert(args->data[1].kind == WASM_I32);
-	auto ret =
-		wasm_memory_cast<ecsact_si_wasi_fdstat_t>(mem, args->data[1].of.i32);
+	auto ret = inst_env.guest_cast<ecsact_si_wasi_fdstat_t>(args->data[1].of.i32);
+
+	if(!ret) {
+		return inst_env.out_of_bounds_trap("fd_fdstat_get");
+	}
 
 	if(default_fdstats.contains(fd)) {
 		*ret = default_fdstats.at(fd);
 	} else {
-		*ret = ecsact::wasm::detail::wasi::fs::fdstat(fd);
+		*ret = ecsact::wasm::detail::wasi::fs::fdstat(inst_env.fd_table, fd);
 	}
 
 	if(ret->fs_filetype != ecsact_si_wasi_filetype::unknown) {
@@ -243,3 +510,288 @@ wasm_trap_t* ecsact_si_wasi_fd_fdstat_get(
 
 	return nullptr;
 }
+
+wasm_trap_t* ecsact_si_wasi_fd_filestat_get(
+	void*                 env,
+	const wasm_val_vec_t* args,
+	wasm_val_vec_t*       results
+) {
+	debug_trace_method("fd_filestat_get");
+	auto& inst_env = get_instance_env(env);
+
+	assert(args->data[0].kind == WASM_I32);
+	auto fd = args->data[0].of.i32;
+
+	assert(args->data[1].kind == WASM_I32);
+	auto ret =
+		inst_env.guest_cast<ecsact_si_wasi_filestat_t>(args->data[1].of.i32);
+
+	if(!ret) {
+		return inst_env.out_of_bounds_trap("fd_filestat_get");
+	}
+
+	auto err = ecsact_si_wasi_errno::success;
+	if(is_stdio_fd(fd)) {
+		*ret = ecsact_si_wasi_filestat_t{
+			.filetype = ecsact_si_wasi_filetype::character_device,
+			.nlink = 1,
+		};
+	} else {
+		auto stat =
+			ecsact::wasm::detail::wasi::fs::filestat(inst_env.fd_table, fd);
+		if(stat) {
+			*ret = *stat;
+		} else {
+			err = ecsact_si_wasi_errno::badf;
+		}
+	}
+
+	results->data[0].kind = WASM_I32;
+	results->data[0].of.i32 = static_cast<int32_t>(err);
+
+	return nullptr;
+}
+
+wasm_trap_t* ecsact_si_wasi_fd_prestat_get(
+	void*                 env,
+	const wasm_val_vec_t* args,
+	wasm_val_vec_t*       results
+) {
+	debug_trace_method("fd_prestat_get");
+	auto& inst_env = get_instance_env(env);
+
+	assert(args->data[0].kind == WASM_I32);
+	auto fd = args->data[0].of.i32;
+
+	assert(args->data[1].kind == WASM_I32);
+	auto ret =
+		inst_env.guest_cast<ecsact_si_wasi_prestat_t>(args->data[1].of.i32);
+
+	if(!ret) {
+		return inst_env.out_of_bounds_trap("fd_prestat_get");
+	}
+
+	auto err = ecsact_si_wasi_errno::badf;
+	auto name = ecsact::wasm::detail::wasi::fs::prestat_dir_name(fd);
+	if(name) {
+		*ret = ecsact_si_wasi_prestat_t{
+			.tag = 0,
+			.pr_name_len = static_cast<uint32_t>(name->size()),
+		};
+		err = ecsact_si_wasi_errno::success;
+	}
+
+	results->data[0].kind = WASM_I32;
+	results->data[0].of.i32 = static_cast<int32_t>(err);
+
+	return nullptr;
+}
+
+wasm_trap_t* ecsact_si_wasi_fd_prestat_dir_name(
+	void*                 env,
+	const wasm_val_vec_t* args,
+	wasm_val_vec_t*       results
+) {
+	debug_trace_method("fd_prestat_dir_name");
+	auto& inst_env = get_instance_env(env);
+
+	assert(args->data[0].kind == WASM_I32);
+	auto fd = args->data[0].of.i32;
+
+	assert(args->data[2].kind == WASM_I32);
+	auto path_len = args->data[2].of.i32;
+
+	assert(args->data[1].kind == WASM_I32);
+	auto path = inst_env.guest_cast<char>(args->data[1].of.i32, path_len);
+
+	if(path_len < 0 || !path) {
+		return inst_env.out_of_bounds_trap("fd_prestat_dir_name");
+	}
+
+	auto err = ecsact_si_wasi_errno::badf;
+	auto name = ecsact::wasm::detail::wasi::fs::prestat_dir_name(fd);
+	if(name) {
+		name->copy(path, static_cast<std::size_t>(path_len));
+		err = ecsact_si_wasi_errno::success;
+	}
+
+	results->data[0].kind = WASM_I32;
+	results->data[0].of.i32 = static_cast<int32_t>(err);
+
+	return nullptr;
+}
+
+wasm_trap_t* ecsact_si_wasi_fd_readdir(
+	void*                 env,
+	const wasm_val_vec_t* args,
+	wasm_val_vec_t*       results
+) {
+	debug_trace_method("fd_readdir");
+	auto& inst_env = get_instance_env(env);
+
+	assert(args->data[0].kind == WASM_I32);
+	auto fd = args->data[0].of.i32;
+
+	assert(args->data[2].kind == WASM_I32);
+	auto buf_len = args->data[2].of.i32;
+
+	assert(args->data[1].kind == WASM_I32);
+	auto buf = inst_env.guest_cast<std::byte>(args->data[1].of.i32, buf_len);
+
+	assert(args->data[3].kind == WASM_I64);
+	auto cookie = static_cast<uint64_t>(args->data[3].of.i64);
+
+	assert(args->data[4].kind == WASM_I32);
+	auto out_used = inst_env.guest_cast<uint32_t>(args->data[4].of.i32);
+
+	if(buf_len < 0 || !buf || !out_used) {
+		return inst_env.out_of_bounds_trap("fd_readdir");
+	}
+
+	auto err = ecsact::wasm::detail::wasi::fs::readdir(
+		inst_env.fd_table,
+		fd,
+		std::span{buf, static_cast<std::size_t>(buf_len)},
+		cookie,
+		*out_used
+	);
+
+	results->data[0].kind = WASM_I32;
+	results->data[0].of.i32 = static_cast<int32_t>(err);
+
+	return nullptr;
+}
+
+wasm_trap_t* ecsact_si_wasi_path_open(
+	void*                 env,
+	const wasm_val_vec_t* args,
+	wasm_val_vec_t*       results
+) {
+	debug_trace_method("path_open");
+	auto& inst_env = get_instance_env(env);
+
+	assert(args->data[0].kind == WASM_I32);
+	auto dir_fd = args->data[0].of.i32;
+
+	assert(args->data[3].kind == WASM_I32);
+	auto path_len = args->data[3].of.i32;
+
+	assert(args->data[2].kind == WASM_I32);
+	auto path = inst_env.guest_cast<const char>(args->data[2].of.i32, path_len);
+
+	assert(args->data[4].kind == WASM_I32);
+	auto oflags = static_cast<ecsact_si_wasi_oflags>(args->data[4].of.i32);
+
+	assert(args->data[5].kind == WASM_I64);
+	auto rights_base = static_cast<ecsact_si_wasi_rights>(args->data[5].of.i64);
+
+	assert(args->data[8].kind == WASM_I32);
+	auto out_fd = inst_env.guest_cast<int32_t>(args->data[8].of.i32);
+
+	if(path_len < 0 || !path || !out_fd) {
+		return inst_env.out_of_bounds_trap("path_open");
+	}
+
+	auto write = (rights_base & ecsact_si_wasi_rights::fd_write) !=
+		ecsact_si_wasi_rights{};
+
+	auto err = ecsact::wasm::detail::wasi::fs::path_open(
+		inst_env.fd_table,
+		dir_fd,
+		std::string_view{path, static_cast<std::size_t>(path_len)},
+		oflags,
+		write,
+		*out_fd
+	);
+
+	results->data[0].kind = WASM_I32;
+	results->data[0].of.i32 = static_cast<int32_t>(err);
+
+	return nullptr;
+}
+
+wasm_trap_t* ecsact_si_wasi_clock_res_get(
+	void*                 env,
+	const wasm_val_vec_t* args,
+	wasm_val_vec_t*       results
+) {
+	debug_trace_method("clock_res_get");
+	auto& inst_env = get_instance_env(env);
+
+	assert(args->data[0].kind == WASM_I32);
+	auto id = static_cast<ecsact_si_wasi_clockid>(args->data[0].of.i32);
+
+	assert(args->data[1].kind == WASM_I32);
+	auto out_resolution = inst_env.guest_cast<uint64_t>(args->data[1].of.i32);
+
+	if(!out_resolution) {
+		return inst_env.out_of_bounds_trap("clock_res_get");
+	}
+
+	auto err = ecsact::wasm::detail::wasi::clock::res_get(id, *out_resolution);
+
+	results->data[0].kind = WASM_I32;
+	results->data[0].of.i32 = static_cast<int32_t>(err);
+
+	return nullptr;
+}
+
+wasm_trap_t* ecsact_si_wasi_clock_time_get(
+	void*                 env,
+	const wasm_val_vec_t* args,
+	wasm_val_vec_t*       results
+) {
+	debug_trace_method("clock_time_get");
+	auto& inst_env = get_instance_env(env);
+
+	assert(args->data[0].kind == WASM_I32);
+	auto id = static_cast<ecsact_si_wasi_clockid>(args->data[0].of.i32);
+
+	// args->data[1] is the requested precision, every clock is as precise as
+	// it gets
+
+	assert(args->data[2].kind == WASM_I32);
+	auto out_time = inst_env.guest_cast<uint64_t>(args->data[2].of.i32);
+
+	if(!out_time) {
+		return inst_env.out_of_bounds_trap("clock_time_get");
+	}
+
+	auto err = ecsact::wasm::detail::wasi::clock::time_get(id, *out_time);
+
+	results->data[0].kind = WASM_I32;
+	results->data[0].of.i32 = static_cast<int32_t>(err);
+
+	return nullptr;
+}
+
+wasm_trap_t* ecsact_si_wasi_random_get(
+	void*                 env,
+	const wasm_val_vec_t* args,
+	wasm_val_vec_t*       results
+) {
+	debug_trace_method("random_get");
+	auto& inst_env = get_instance_env(env);
+
+	assert(args->data[1].kind == WASM_I32);
+	auto buf_len = args->data[1].of.i32;
+
+	assert(args->data[0].kind == WASM_I32);
+	auto buf = inst_env.guest_cast<std::byte>(args->data[0].of.i32, buf_len);
+
+	if(buf_len < 0 || !buf) {
+		return inst_env.out_of_bounds_trap("random_get");
+	}
+
+	ecsact::wasm::detail::wasi::clock::random_get(
+		inst_env.current_system_id,
+		inst_env.current_entity,
+		inst_env.random_counter,
+		std::span{buf, static_cast<std::size_t>(buf_len)}
+	);
+
+	results->data[0].kind = WASM_I32;
+	results->data[0].of.i32 = 0;
+
+	return nullptr;
+}
@@ -305,6 +305,105 @@ inline ecsact_si_wasi_rights operator&(
 	);
 }
 
+/**
+ * Error codes returned by WASI functions. Only the ones the host uses are
+ * listed.
+ */
+enum class ecsact_si_wasi_errno : uint16_t {
+	/**
+	 * No error occurred.
+	 */
+	success = 0,
+
+	/**
+	 * Bad file descriptor.
+	 */
+	badf = 8,
+
+	/**
+	 * Invalid argument.
+	 */
+	inval = 28,
+
+	/**
+	 * Is a directory.
+	 */
+	isdir = 31,
+
+	/**
+	 * No such file or directory.
+	 */
+	noent = 44,
+
+	/**
+	 * Not a directory or a symbolic link to a directory.
+	 */
+	notdir = 54,
+
+	/**
+	 * Read-only file system.
+	 */
+	rofs = 69,
+
+	/**
+	 * Invalid seek.
+	 */
+	spipe = 70,
+
+	/**
+	 * Extension: Capabilities insufficient.
+	 */
+	notcapable = 76,
+};
+
+/**
+ * Identifiers for clocks.
+ */
+enum class ecsact_si_wasi_clockid : uint32_t {
+	/**
+	 * The clock measuring real time. Time value zero corresponds with
+	 * 1970-01-01T00:00:00Z.
+	 */
+	realtime = 0,
+
+	/**
+	 * The store-wide monotonic clock, which is defined as a clock measuring
+	 * real time, whose value cannot be adjusted and which cannot have negative
+	 * clock jumps.
+	 */
+	monotonic = 1,
+
+	/**
+	 * The CPU-time clock associated with the current process.
+	 */
+	process_cputime_id = 2,
+
+	/**
+	 * The CPU-time clock associated with the current thread.
+	 */
+	thread_cputime_id = 3,
+};
+
+/**
+ * The position relative to which to set the offset of the file descriptor.
+ */
+enum class ecsact_si_wasi_whence : uint8_t {
+	/**
+	 * Seek relative to start-of-file.
+	 */
+	set = 0,
+
+	/**
+	 * Seek relative to current position.
+	 */
+	cur = 1,
+
+	/**
+	 * Seek relative to end-of-file.
+	 */
+	end = 2,
+};
+
 typedef struct ecsact_si_wasi_fdstat_t {
 	/**
 	 * File type.
@@ -331,6 +430,139 @@ typedef struct ecsact_si_wasi_fdstat_t {
 
 static_assert(sizeof(ecsact_si_wasi_fdstat_t) == 24);
 
+/**
+ * File attributes.
+ */
+typedef struct ecsact_si_wasi_filestat_t {
+	/**
+	 * Device ID of device containing the file.
+	 */
+	uint64_t dev;
+
+	/**
+	 * File serial number.
+	 */
+	uint64_t ino;
+
+	/**
+	 * File type.
+	 */
+	ecsact_si_wasi_filetype filetype;
+
+	/**
+	 * Number of hard links to the file.
+	 */
+	uint64_t nlink;
+
+	/**
+	 * For regular files, the file size in bytes.
+	 */
+	uint64_t size;
+
+	/**
+	 * Last data access timestamp.
+	 */
+	uint64_t atim;
+
+	/**
+	 * Last data modification timestamp.
+	 */
+	uint64_t mtim;
+
+	/**
+	 * Last file status change timestamp.
+	 */
+	uint64_t ctim;
+} ecsact_si_wasi_filestat_t;
+
+static_assert(sizeof(ecsact_si_wasi_filestat_t) == 64);
+
+/**
+ * Open flags used by `path_open`.
+ */
+enum class ecsact_si_wasi_oflags : uint16_t {
+	/**
+	 * Create file if it does not exist.
+	 */
+	creat = 1 << 0,
+
+	/**
+	 * Fail if not a directory.
+	 */
+	directory = 1 << 1,
+
+	/**
+	 * Fail if file already exists.
+	 */
+	excl = 1 << 2,
+
+	/**
+	 * Truncate file to size 0.
+	 */
+	trunc = 1 << 3,
+};
+
+inline ecsact_si_wasi_oflags operator|(
+	ecsact_si_wasi_oflags a,
+	ecsact_si_wasi_oflags b
+) {
+	return static_cast<ecsact_si_wasi_oflags>(
+		static_cast<uint16_t>(a) | static_cast<uint16_t>(b)
+	);
+}
+
+inline ecsact_si_wasi_oflags operator&(
+	ecsact_si_wasi_oflags a,
+	ecsact_si_wasi_oflags b
+) {
+	return static_cast<ecsact_si_wasi_oflags>(
+		static_cast<uint16_t>(a) & static_cast<uint16_t>(b)
+	);
+}
+
+/**
+ * A directory entry header as written by `fd_readdir`. The name follows
+ * directly after it and is not null terminated.
+ */
+typedef struct ecsact_si_wasi_dirent_t {
+	/**
+	 * The offset of the next directory entry stored in this directory.
+	 */
+	uint64_t d_next;
+
+	/**
+	 * The serial number of the file referred to by this directory entry.
+	 */
+	uint64_t d_ino;
+
+	/**
+	 * The length of the name of the directory entry.
+	 */
+	uint32_t d_namlen;
+
+	/**
+	 * The type of the file referred to by this directory entry.
+	 */
+	ecsact_si_wasi_filetype d_type;
+} ecsact_si_wasi_dirent_t;
+
+static_assert(sizeof(ecsact_si_wasi_dirent_t) == 24);
+
+/**
+ * Information about a pre-opened capability. Only directories can be
+ * pre-opened so the tag is always `0`.
+ */
+typedef struct ecsact_si_wasi_prestat_t {
+	uint8_t tag;
+
+	/**
+	 * The length of the directory name for use with `fd_prestat_dir_name`.
+	 */
+	uint32_t pr_name_len;
+} ecsact_si_wasi_prestat_t;
+
+static_assert(sizeof(ecsact_si_wasi_prestat_t) == 8);
+
 /**
  * Ecsact system implementation exited prematurely. Unlike normal usage of this
  * function @p exit_code being `0` does NOT mean success.
@@ -339,41 +571,109 @@ static_assert(sizeof(ecsact_si_wasi_fdstat_t) == 24);
  */
 // void ecsact_si_wasi_proc_exit(int32_t exit_code);
 wasm_trap_t* ecsact_si_wasi_proc_exit(
+	void*                 env,
 	const wasm_val_vec_t* args,
 	wasm_val_vec_t*       results
 );
 
 wasm_trap_t* ecsact_si_wasi_fd_seek(
+	void*                 env,
+	const wasm_val_vec_t* args,
+	wasm_val_vec_t*       results
+);
+
+wasm_trap_t* ecsact_si_wasi_fd_tell(
+	void*                 env,
 	const wasm_val_vec_t* args,
 	wasm_val_vec_t*       results
 );
 
 wasm_trap_t* ecsact_si_wasi_fd_write(
+	void*                 env,
 	const wasm_val_vec_t* args,
 	wasm_val_vec_t*       results
 );
 
 wasm_trap_t* ecsact_si_wasi_fd_read(
+	void*                 env,
+	const wasm_val_vec_t* args,
+	wasm_val_vec_t*       results
+);
+
+wasm_trap_t* ecsact_si_wasi_fd_pread(
+	void*                 env,
 	const wasm_val_vec_t* args,
 	wasm_val_vec_t*       results
 );
 
 wasm_trap_t* ecsact_si_wasi_fd_close(
+	void*                 env,
 	const wasm_val_vec_t* args,
 	wasm_val_vec_t*       results
 );
 
 wasm_trap_t* ecsact_si_wasi_environ_sizes_get(
+	void*                 env,
 	const wasm_val_vec_t* args,
 	wasm_val_vec_t*       results
 );
 
 wasm_trap_t* ecsact_si_wasi_environ_get(
+	void*                 env,
 	const wasm_val_vec_t* args,
 	wasm_val_vec_t*       results
 );
 
 wasm_trap_t* ecsact_si_wasi_fd_fdstat_get(
+	void*                 env,
+	const wasm_val_vec_t* args,
+	wasm_val_vec_t*       results
+);
+
+wasm_trap_t* ecsact_si_wasi_fd_filestat_get(
+	void*                 env,
+	const wasm_val_vec_t* args,
+	wasm_val_vec_t*       results
+);
+
+wasm_trap_t* ecsact_si_wasi_fd_prestat_get(
+	void*                 env,
+	const wasm_val_vec_t* args,
+	wasm_val_vec_t*       results
+);
+
+wasm_trap_t* ecsact_si_wasi_fd_prestat_dir_name(
+	void*                 env,
+	const wasm_val_vec_t* args,
+	wasm_val_vec_t*       results
+);
+
+wasm_trap_t* ecsact_si_wasi_fd_readdir(
+	void*                 env,
+	const wasm_val_vec_t* args,
+	wasm_val_vec_t*       results
+);
+
+wasm_trap_t* ecsact_si_wasi_path_open(
+	void*                 env,
+	const wasm_val_vec_t* args,
+	wasm_val_vec_t*       results
+);
+
+wasm_trap_t* ecsact_si_wasi_clock_res_get(
+	void*                 env,
+	const wasm_val_vec_t* args,
+	wasm_val_vec_t*       results
+);
+
+wasm_trap_t* ecsact_si_wasi_clock_time_get(
+	void*                 env,
+	const wasm_val_vec_t* args,
+	wasm_val_vec_t*       results
+);
+
+wasm_trap_t* ecsact_si_wasi_random_get(
+	void*                 env,
 	const wasm_val_vec_t* args,
 	wasm_val_vec_t*       results
 );
@@ -0,0 +1,163 @@
+#include "ecsact/si/wasmer/detail/wasi_clock.hh"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <random>
+
+namespace {
+auto deterministic = std::atomic_bool{false};
+auto tick_duration_ns = std::atomic_int64_t{1};
+auto ticks = std::atomic_uint64_t{0};
+auto seed = std::atomic_uint64_t{0};
+
+/**
+ * splitmix64 finalizer, a cheap bijective mix of all 64 bits
+ */
+constexpr auto mix(std::uint64_t x) -> std::uint64_t {
+	x += 0x9E3779B97F4A7C15;
+	x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9;
+	x = (x ^ (x >> 27)) * 0x94D049BB133111EB;
+	return x ^ (x >> 31);
+}
+
+auto is_known_clock(ecsact_si_wasi_clockid id) -> bool {
+	return static_cast<std::uint32_t>(id) <=
+		static_cast<std::uint32_t>(ecsact_si_wasi_clockid::thread_cputime_id);
+}
+
+/**
+ * `ticks * tick_duration_ns`, saturated at the largest time a clock can report
+ */
+auto deterministic_time_ns() -> std::uint64_t {
+	auto current_ticks = ticks.load(std::memory_order_relaxed);
+	auto duration = static_cast<std::uint64_t>(
+		tick_duration_ns.load(std::memory_order_relaxed)
+	);
+	if(current_ticks > UINT64_MAX / duration) {
+		return UINT64_MAX;
+	}
+	return current_ticks * duration;
+}
+
+template<typename Clock>
+auto now_ns() -> std::uint64_t {
+	return static_cast<std::uint64_t>(
+		std::chrono::duration_cast<std::chrono::nanoseconds>(
+			Clock::now().time_since_epoch()
+		)
+			.count()
+	);
+}
+
+template<typename Clock>
+constexpr auto resolution_ns() -> std::uint64_t {
+	return std::max<std::uint64_t>(
+		std::chrono::duration_cast<std::chrono::nanoseconds>(
+			typename Clock::duration{1}
+		)
+			.count(),
+		1
+	);
+}
+} // namespace
+
+auto ecsact::wasm::detail::wasi::clock::enable_deterministic(
+	std::int64_t  new_tick_duration_ns,
+	std::uint64_t new_seed
+) -> void {
+	tick_duration_ns = std::max<std::int64_t>(new_tick_duration_ns, 1);
+	seed = new_seed;
+	ticks = 0;
+	deterministic = true;
+}
+
+auto ecsact::wasm::detail::wasi::clock::disable_deterministic() -> void {
+	deterministic = false;
+}
+
+auto ecsact::wasm::detail::wasi::clock::advance_ticks(std::int64_t count)
+	-> void {
+	if(count > 0) {
+		ticks.fetch_add(
+			static_cast<std::uint64_t>(count),
+			std::memory_order_relaxed
+		);
+	}
+}
+
+auto ecsact::wasm::detail::wasi::clock::time_get(
+	ecsact_si_wasi_clockid id,
+	std::uint64_t&         out_time
+) -> ecsact_si_wasi_errno {
+	if(!is_known_clock(id)) {
+		return ecsact_si_wasi_errno::inval;
+	}
+
+	if(deterministic.load(std::memory_order_relaxed)) {
+		out_time = deterministic_time_ns();
+	} else if(id == ecsact_si_wasi_clockid::realtime) {
+		out_time = now_ns<std::chrono::system_clock>();
+	} else {
+		// There is no portable per-process or per-thread CPU clock so the cputime
+		// clocks are the monotonic clock, good enough for timing guest code
+		out_time = now_ns<std::chrono::steady_clock>();
+	}
+
+	return ecsact_si_wasi_errno::success;
+}
+
+auto ecsact::wasm::detail::wasi::clock::res_get(
+	ecsact_si_wasi_clockid id,
+	std::uint64_t&         out_resolution
+) -> ecsact_si_wasi_errno {
+	if(!is_known_clock(id)) {
+		return ecsact_si_wasi_errno::inval;
+	}
+
+	if(deterministic.load(std::memory_order_relaxed)) {
+		out_resolution = static_cast<std::uint64_t>(
+			tick_duration_ns.load(std::memory_order_relaxed)
+		);
+	} else if(id == ecsact_si_wasi_clockid::realtime) {
+		out_resolution = resolution_ns<std::chrono::system_clock>();
+	} else {
+		out_resolution = resolution_ns<std::chrono::steady_clock>();
+	}
+
+	return ecsact_si_wasi_errno::success;
+}
+
+auto ecsact::wasm::detail::wasi::clock::random_get(
+	ecsact_system_like_id system_id,
+	ecsact_entity_id      entity,
+	std::uint64_t&        random_counter,
+	std::span<std::byte>  out
+) -> void {
+	if(!deterministic.load(std::memory_order_relaxed)) {
+		static thread_local auto device = std::random_device{};
+		while(!out.empty()) {
+			auto word = device();
+			auto amount = std::min(out.size(), sizeof(word));
+			std::memcpy(out.data(), &word, amount);
+			out = out.subspan(amount);
+		}
+		return;
+	}
+
+	auto tick = ticks.load(std::memory_order_relaxed);
+	auto key = mix(seed.load(std::memory_order_relaxed));
+	key = mix(key ^ tick);
+	key = mix(key ^ static_cast<std::uint32_t>(system_id));
+	key = mix(key ^ static_cast<std::uint32_t>(entity));
+
+	while(!out.empty()) {
+		auto word = mix(key + random_counter);
+		random_counter += 1;
+		auto amount = std::min(out.size(), sizeof(word));
+		std::memcpy(out.data(), &word, amount);
+		out = out.subspan(amount);
+	}
+}
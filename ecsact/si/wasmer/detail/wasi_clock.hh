@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include "ecsact/runtime/common.h"
+#include "ecsact/si/wasmer/detail/wasi.hh"
+
+namespace ecsact::wasm::detail::wasi::clock {
+
+/**
+ * Switches clocks and randomness to deterministic mode. Clocks report
+ * `ticks * tick_duration_ns` and only move with `advance_ticks`. Random bytes
+ * are derived from @p seed, the current tick and the executing system and
+ * entity, so they do not depend on which instance or thread runs a system.
+ */
+auto enable_deterministic(std::int64_t tick_duration_ns, std::uint64_t seed)
+	-> void;
+
+auto disable_deterministic() -> void;
+
+auto advance_ticks(std::int64_t ticks) -> void;
+
+auto time_get(ecsact_si_wasi_clockid id, std::uint64_t& out_time)
+	-> ecsact_si_wasi_errno;
+
+auto res_get(ecsact_si_wasi_clockid id, std::uint64_t& out_resolution)
+	-> ecsact_si_wasi_errno;
+
+/**
+ * Fills @p out with random bytes.
+ *
+ * @param random_counter words already handed out during the current system
+ *        impl call. Only used (and advanced) in deterministic mode.
+ */
+auto random_get(
+	ecsact_system_like_id system_id,
+	ecsact_entity_id      entity,
+	std::uint64_t&        random_counter,
+	std::span<std::byte>  out
+) -> void;
+
+} // namespace ecsact::wasm::detail::wasi::clock
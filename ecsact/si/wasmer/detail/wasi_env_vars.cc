@@ -0,0 +1,31 @@
+#include "ecsact/si/wasmer/detail/wasi_env_vars.hh"
+
+#include <mutex>
+
+using ecsact::wasm::detail::wasi::env_vars::environment_block;
+
+namespace {
+auto environment_mutex = std::mutex{};
+auto environment = std::make_shared<const environment_block>();
+} // namespace
+
+auto ecsact::wasm::detail::wasi::env_vars::set_environment(
+	const std::vector<std::string>& vars
+) -> void {
+	auto block = std::make_shared<environment_block>();
+	block->offsets.reserve(vars.size());
+	for(auto& var : vars) {
+		block->offsets.push_back(static_cast<std::uint32_t>(block->buffer.size()));
+		block->buffer += var;
+		block->buffer += '\0';
+	}
+
+	auto lk = std::scoped_lock{environment_mutex};
+	environment = std::move(block);
+}
+
+auto ecsact::wasm::detail::wasi::env_vars::current_environment()
+	-> std::shared_ptr<const environment_block> {
+	auto lk = std::scoped_lock{environment_mutex};
+	return environment;
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace ecsact::wasm::detail::wasi::env_vars {
+
+/**
+ * Environment variables laid out the way `environ_get` hands them to guests:
+ * `KEY=VALUE` strings, each null terminated, back to back in one buffer.
+ */
+struct environment_block {
+	std::string buffer;
+
+	/**
+	 * Offset of every variable in `buffer`
+	 */
+	std::vector<std::uint32_t> offsets;
+};
+
+/**
+ * Replaces the environment given to instances that have not read theirs yet.
+ * Each of @p vars is a `KEY=VALUE` string.
+ */
+auto set_environment(const std::vector<std::string>& vars) -> void;
+
+/**
+ * The current environment, shared and never modified
+ */
+auto current_environment() -> std::shared_ptr<const environment_block>;
+
+} // namespace ecsact::wasm::detail::wasi::env_vars
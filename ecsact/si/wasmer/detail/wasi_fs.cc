@@ -1,117 +1,868 @@
 #include "ecsact/si/wasmer/detail/wasi_fs.hh"
 
 #include <map>
-#include <cstdio>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <mutex>
 #include <optional>
+#include <span>
 #include <string>
+#include <utility>
+#include <vector>
+#include "ecsact/si/wasmer/detail/mapped_file.hh"
+#include "ecsact/si/wasmer/detail/file_writer.hh"
 
-struct virtual_file_info {
-	std::string virtual_path;
-	std::string real_path;
-	int32_t     pseudo_file_descriptor;
+using ecsact::wasm::detail::mapped_file;
+using ecsact::wasm::detail::output_file_writer;
+using ecsact::wasm::detail::wasi::fs::allowed_dir;
+using ecsact::wasm::detail::wasi::fs::allowed_file;
+using ecsact::wasm::detail::wasi::fs::fd_table;
+using ecsact::wasm::detail::wasi::fs::open_file;
+using ecsact::wasm::detail::wasi::fs::preopen_fd_begin;
+using ecsact::wasm::detail::wasi::fs::preopen_fd_end;
 
-	// if set the file is open
-	std::optional<std::FILE*> opened_file;
-	ecsact_si_wasi_fdstat_t   fdstat = {};
+class ecsact::wasm::detail::wasi::fs::allowed_file {
+public:
+	std::string             virtual_path;
+	std::string             real_path;
+	int32_t                 pseudo_file_descriptor;
+	ecsact_si_wasi_fdstat_t fdstat = {};
+
+	/**
+	 * Set for files registered from memory. Served as is, the file at
+	 * `real_path` (if any) is never touched again.
+	 */
+	std::optional<std::vector<std::byte>> preloaded;
+
+	/**
+	 * `file_writer` id for files guests write to instead of read, or -1
+	 */
+	std::int32_t output_file_id = -1;
+
+	/**
+	 * Maps the file on first call unless it is preloaded. Every instance
+	 * shares the one mapping.
+	 */
+	auto contents() const -> std::optional<std::span<const std::byte>> {
+		if(preloaded) {
+			return std::span{*preloaded};
+		}
+
+		if(output_file_id != -1) {
+			return std::nullopt;
+		}
+
+		std::call_once(_mapping_once, [this] {
+			_mapping = mapped_file::open(real_path);
+		});
+		if(!_mapping) {
+			return std::nullopt;
+		}
+		return _mapping->data();
+	}
+
+private:
+	mutable std::once_flag                     _mapping_once;
+	mutable std::shared_ptr<const mapped_file> _mapping;
+};
+
+static auto make_allowed_file(
+	std::string_view real_path,
+	std::string_view virtual_path,
+	int32_t          fd
+) -> std::shared_ptr<allowed_file> {
+	auto file = std::make_shared<allowed_file>();
+	file->pseudo_file_descriptor = fd;
+	file->virtual_path = virtual_path;
+	file->real_path = real_path;
+	file->fdstat = {
+		.fs_filetype = ecsact_si_wasi_filetype::regular_file,
+		.fs_flags = ecsact_si_wasi_fdflags::rsync | ecsact_si_wasi_fdflags::sync,
+		.fs_rights_base = ecsact_si_wasi_rights::fd_read |
+			ecsact_si_wasi_rights::fd_seek | ecsact_si_wasi_rights::fd_tell |
+			ecsact_si_wasi_rights::fd_filestat_get,
+		.fs_rights_inheriting = {},
+	};
+	return file;
+}
+
+static auto to_filetype(std::filesystem::file_type type)
+	-> ecsact_si_wasi_filetype {
+	switch(type) {
+		case std::filesystem::file_type::regular:
+			return ecsact_si_wasi_filetype::regular_file;
+		case std::filesystem::file_type::directory:
+			return ecsact_si_wasi_filetype::directory;
+		default:
+			return ecsact_si_wasi_filetype::unknown;
+	}
+}
+
+class ecsact::wasm::detail::wasi::fs::allowed_dir {
+public:
+	struct entry {
+		ecsact_si_wasi_filetype             type;
+		std::shared_ptr<const allowed_file> file;
+	};
+
+	using listing = std::vector<std::pair<std::string, ecsact_si_wasi_filetype>>;
+
+	std::string           virtual_path;
+	std::filesystem::path real_path;
+	int32_t               pseudo_file_descriptor;
+
+	/**
+	 * Reads the whole tree below `real_path` so lookups stay in memory
+	 */
+	auto build_index() -> void {
+		_index.emplace();
+		_index->type = ecsact_si_wasi_filetype::directory;
+		index_dir(*_index, real_path, "");
+	}
+
+	/**
+	 * @param rel_path normalized path relative to `real_path`
+	 */
+	auto find(const std::string& rel_path) const -> std::optional<entry> {
+		if(_index) {
+			auto node = find_node(rel_path);
+			if(!node) {
+				return std::nullopt;
+			}
+			return entry{node->type, node->file};
+		}
+
+		auto ec = std::error_code{};
+		auto path = std::filesystem::canonical(real_path / rel_path, ec);
+		if(ec || !is_inside(path)) {
+			return std::nullopt;
+		}
+
+		auto type = to_filetype(std::filesystem::status(path, ec).type());
+		if(ec || type == ecsact_si_wasi_filetype::unknown) {
+			return std::nullopt;
+		}
+
+		if(type == ecsact_si_wasi_filetype::directory) {
+			return entry{type, nullptr};
+		}
+
+		return entry{
+			type,
+			make_allowed_file(path.string(), virtual_path + "/" + rel_path, -1),
+		};
+	}
+
+	/**
+	 * Entries of the directory at @p rel_path sorted by name
+	 */
+	auto list(const std::string& rel_path) const -> std::optional<listing> {
+		auto result = listing{};
+
+		if(_index) {
+			auto node = find_node(rel_path);
+			if(!node || node->type != ecsact_si_wasi_filetype::directory) {
+				return std::nullopt;
+			}
+
+			result.reserve(node->children.size());
+			for(auto& [name, child] : node->children) {
+				result.emplace_back(name, child.type);
+			}
+			return result;
+		}
+
+		auto ec = std::error_code{};
+		auto path = std::filesystem::canonical(real_path / rel_path, ec);
+		if(ec || !is_inside(path)) {
+			return std::nullopt;
+		}
+
+		for(auto itr = std::filesystem::directory_iterator{path, ec};
+				!ec && itr != std::filesystem::directory_iterator{};
+				itr.increment(ec)) {
+			auto entry_ec = std::error_code{};
+			auto type = to_filetype(itr->status(entry_ec).type());
+			auto entry_path = std::filesystem::canonical(itr->path(), entry_ec);
+			if(!entry_ec && type != ecsact_si_wasi_filetype::unknown &&
+				 is_inside(entry_path)) {
+				result.emplace_back(itr->path().filename().string(), type);
+			}
+		}
+		if(ec) {
+			return std::nullopt;
+		}
+
+		std::sort(result.begin(), result.end());
+		return result;
+	}
+
+private:
+	struct index_node {
+		ecsact_si_wasi_filetype             type;
+		std::shared_ptr<const allowed_file> file;
+
+		/**
+		 * Sorted by name
+		 */
+		std::vector<std::pair<std::string, index_node>> children;
+	};
+
+	std::optional<index_node> _index;
+
+	auto index_dir(
+		index_node&                  node,
+		const std::filesystem::path& path,
+		const std::string&           rel_path
+	) -> void {
+		auto ec = std::error_code{};
+		for(auto& dir_entry : std::filesystem::directory_iterator{path, ec}) {
+			auto type = to_filetype(dir_entry.status(ec).type());
+			if(ec || type == ecsact_si_wasi_filetype::unknown) {
+				continue;
+			}
+
+			// Linked directories could form cycles and linked files could point
+			// outside of the preopen
+			auto real_entry_path = std::filesystem::canonical(dir_entry.path(), ec);
+			if(ec || !is_inside(real_entry_path)) {
+				continue;
+			}
+			if(type == ecsact_si_wasi_filetype::directory &&
+				 dir_entry.is_symlink(ec)) {
+				continue;
+			}
+
+			auto name = dir_entry.path().filename().string();
+			auto child_rel_path = rel_path.empty() ? name : rel_path + "/" + name;
+			auto child = index_node{.type = type};
+			if(type == ecsact_si_wasi_filetype::directory) {
+				index_dir(child, dir_entry.path(), child_rel_path);
+			} else {
+				child.file = make_allowed_file(
+					real_entry_path.string(),
+					virtual_path + "/" + child_rel_path,
+					-1
+				);
+			}
+
+			node.children.emplace_back(std::move(name), std::move(child));
+		}
+
+		std::sort(
+			node.children.begin(),
+			node.children.end(),
+			[](auto& a, auto& b) { return a.first < b.first; }
+		);
+	}
+
+	auto find_node(std::string_view rel_path) const -> const index_node* {
+		auto node = &*_index;
+		while(!rel_path.empty()) {
+			auto slash = rel_path.find('/');
+			auto name = rel_path.substr(0, slash);
+			rel_path = slash == std::string_view::npos //
+				? std::string_view{}
+				: rel_path.substr(slash + 1);
+
+			auto itr = std::lower_bound(
+				node->children.begin(),
+				node->children.end(),
+				name,
+				[](auto& child, auto name) { return child.first < name; }
+			);
+			if(itr == node->children.end() || itr->first != name) {
+				return nullptr;
+			}
+			node = &itr->second;
+		}
+		return node;
+	}
+
+	/**
+	 * Symbolic links may point outside of the preopen
+	 */
+	auto is_inside(const std::filesystem::path& path) const -> bool {
+		auto [root_end, _] = std::mismatch(
+			real_path.begin(),
+			real_path.end(),
+			path.begin(),
+			path.end()
+		);
+		return root_end == real_path.end();
+	}
 };
 
-static auto last_file_descriptor = int32_t{10};
-static auto virtual_files = std::map<int32_t, virtual_file_info>{};
-static auto virtual_file_map = std::map<std::string, int32_t>{};
+namespace {
+/**
+ * Snapshot of every allowed file. Registering a file publishes a new snapshot
+ * so lookups never see a table that is being modified.
+ */
+struct allowed_files_table {
+	std::map<int32_t, std::shared_ptr<const allowed_file>> files;
+	std::map<std::string, int32_t, std::less<>>            virtual_file_map;
+	std::map<int32_t, std::shared_ptr<const allowed_dir>>  dirs;
+};
+
+auto last_file_descriptor = int32_t{10};
+auto allowed_files_mutex = std::mutex{};
+auto allowed_files = std::make_shared<const allowed_files_table>();
 
-static auto erase_virtual_if_exists(std::string_view virtual_path) {
-	const auto virtual_path_s = std::string{virtual_path};
+auto allowed_files_snapshot() -> std::shared_ptr<const allowed_files_table> {
+	auto lk = std::scoped_lock{allowed_files_mutex};
+	return allowed_files;
+}
+
+auto find_allowed(int32_t fd) -> std::shared_ptr<const allowed_file> {
+	auto snapshot = allowed_files_snapshot();
+	auto itr = snapshot->files.find(fd);
+	if(itr == snapshot->files.end()) {
+		return nullptr;
+	}
+	return itr->second;
+}
+
+auto find_allowed_dir(int32_t fd) -> std::shared_ptr<const allowed_dir> {
+	auto snapshot = allowed_files_snapshot();
+	auto itr = snapshot->dirs.find(fd);
+	if(itr == snapshot->dirs.end()) {
+		return nullptr;
+	}
+	return itr->second;
+}
 
-	auto itr = virtual_file_map.find(virtual_path_s);
-	if(itr != virtual_file_map.end()) {
-		virtual_files.erase(itr->second);
-		virtual_file_map.erase(itr);
+auto find_allowed(std::string_view virtual_path)
+	-> std::shared_ptr<const allowed_file> {
+	auto snapshot = allowed_files_snapshot();
+	auto itr = snapshot->virtual_file_map.find(virtual_path);
+	if(itr == snapshot->virtual_file_map.end()) {
+		return nullptr;
 	}
+	return snapshot->files.at(itr->second);
 }
 
+/**
+ * Finds @p fd in @p table, opening it if it is an allowed file this instance
+ * has not used yet. Only opening touches the shared table.
+ */
+auto find_open(fd_table& table, int32_t fd) -> open_file* {
+	auto itr = table.open_files.find(fd);
+	if(itr != table.open_files.end()) {
+		return &itr->second;
+	}
+
+	if(fd >= preopen_fd_begin && fd < preopen_fd_end) {
+		auto dir = find_allowed_dir(fd);
+		if(!dir) {
+			return nullptr;
+		}
+
+		auto& open = table.open_files[fd];
+		open.dir = std::move(dir);
+		return &open;
+	}
+
+	auto file = find_allowed(fd);
+	if(!file) {
+		return nullptr;
+	}
+
+	auto& open = table.open_files[fd];
+	open.file = std::move(file);
+	return &open;
+}
+
+auto find_contents(fd_table& table, int32_t fd)
+	-> std::pair<open_file*, std::optional<std::span<const std::byte>>> {
+	auto open = find_open(table, fd);
+	if(!open || !open->file) {
+		return {};
+	}
+
+	return {open, open->file->contents()};
+}
+
+/**
+ * Publishes @p file under a new descriptor, replacing any file with the same
+ * virtual path
+ */
+auto register_file(std::shared_ptr<allowed_file> file) -> int32_t {
+	auto lk = std::scoped_lock{allowed_files_mutex};
+	auto table = std::make_shared<allowed_files_table>(*allowed_files);
+
+	auto existing = table->virtual_file_map.find(file->virtual_path);
+	if(existing != table->virtual_file_map.end()) {
+		table->files.erase(existing->second);
+		table->virtual_file_map.erase(existing);
+	}
+
+	auto fd = ++last_file_descriptor;
+	file->pseudo_file_descriptor = fd;
+	table->virtual_file_map[file->virtual_path] = fd;
+	table->files[fd] = std::move(file);
+	allowed_files = std::move(table);
+
+	return fd;
+}
+
+/**
+ * Joins @p path onto the directory @p base, resolving `.` and `..`.
+ *
+ * @returns `std::nullopt` if the result would leave the root @p base is in
+ */
+auto join_relative(std::string_view base, std::string_view path)
+	-> std::optional<std::string> {
+	if(path.starts_with('/')) {
+		return std::nullopt;
+	}
+
+	auto components = std::vector<std::string_view>{};
+	for(auto part : {base, path}) {
+		while(!part.empty()) {
+			auto slash = part.find('/');
+			auto component = part.substr(0, slash);
+			part = slash == std::string_view::npos //
+				? std::string_view{}
+				: part.substr(slash + 1);
+
+			if(component.empty() || component == ".") {
+				continue;
+			}
+
+			if(component == "..") {
+				if(components.empty()) {
+					return std::nullopt;
+				}
+				components.pop_back();
+				continue;
+			}
+
+			components.push_back(component);
+		}
+	}
+
+	auto result = std::string{};
+	for(auto component : components) {
+		if(!result.empty()) {
+			result += '/';
+		}
+		result += component;
+	}
+	return result;
+}
+
+auto copy_at(
+	std::span<const std::byte> data,
+	std::uint64_t              offset,
+	std::span<std::byte>       out
+) -> std::size_t {
+	if(offset >= data.size()) {
+		return 0;
+	}
+
+	auto amount = std::min<std::size_t>(out.size(), data.size() - offset);
+	std::memcpy(out.data(), data.data() + offset, amount);
+	return amount;
+}
+} // namespace
+
 auto ecsact::wasm::detail::wasi::fs::allow_file_read_access(
 	std::string_view real_path,
 	std::string_view virtual_path
 ) -> std::int32_t {
-	erase_virtual_if_exists(virtual_path);
-
-	auto  fd = ++last_file_descriptor;
-	auto& virtual_file_info = virtual_files[fd];
-	virtual_file_info.pseudo_file_descriptor = fd;
-	virtual_file_info.virtual_path = virtual_path;
-	virtual_file_info.real_path = real_path;
-	virtual_file_info.fdstat = {
+	return register_file(make_allowed_file(real_path, virtual_path, -1));
+}
+
+auto ecsact::wasm::detail::wasi::fs::allow_file_read_buffer(
+	std::string_view       virtual_path,
+	std::vector<std::byte> data
+) -> std::int32_t {
+	auto file = make_allowed_file("", virtual_path, -1);
+	file->preloaded = std::move(data);
+	return register_file(std::move(file));
+}
+
+auto ecsact::wasm::detail::wasi::fs::preload_file(
+	std::string_view real_path,
+	std::string_view virtual_path
+) -> std::int32_t {
+	auto path = std::filesystem::path{real_path};
+	auto ec = std::error_code{};
+
+	// Pipes and devices have no size to read up front
+	if(!std::filesystem::is_regular_file(path, ec)) {
+		return -1;
+	}
+
+	auto stream = std::ifstream{path, std::ios::binary | std::ios::ate};
+	if(!stream) {
+		return -1;
+	}
+
+	auto size = static_cast<std::streamoff>(stream.tellg());
+	if(size < 0) {
+		return -1;
+	}
+
+	auto data = std::vector<std::byte>(static_cast<std::size_t>(size));
+	stream.seekg(0);
+	stream.read(reinterpret_cast<char*>(data.data()), data.size());
+	if(!stream) {
+		return -1;
+	}
+
+	auto file = make_allowed_file(real_path, virtual_path, -1);
+	file->preloaded = std::move(data);
+	return register_file(std::move(file));
+}
+
+auto ecsact::wasm::detail::wasi::fs::allow_file_write_access(
+	std::string_view real_path,
+	std::string_view virtual_path
+) -> std::int32_t {
+	auto output_file_id = output_file_writer().open(std::string{real_path});
+	if(output_file_id == -1) {
+		return -1;
+	}
+
+	auto file = make_allowed_file(real_path, virtual_path, -1);
+	file->output_file_id = output_file_id;
+	file->fdstat = {
 		.fs_filetype = ecsact_si_wasi_filetype::regular_file,
-		.fs_flags = ecsact_si_wasi_fdflags::rsync | ecsact_si_wasi_fdflags::sync,
-		.fs_rights_base = ecsact_si_wasi_rights::fd_read |
-			ecsact_si_wasi_rights::fd_seek,
+		.fs_flags = ecsact_si_wasi_fdflags::append,
+		.fs_rights_base = ecsact_si_wasi_rights::fd_write,
 		.fs_rights_inheriting = {},
 	};
+	return register_file(std::move(file));
+}
+
+auto ecsact::wasm::detail::wasi::fs::allow_dir_read_access(
+	std::string_view real_path,
+	std::string_view virtual_path,
+	bool             build_index
+) -> std::int32_t {
+	auto ec = std::error_code{};
+	auto dir = std::make_shared<allowed_dir>();
+	dir->virtual_path = virtual_path;
+	dir->real_path = std::filesystem::canonical(real_path, ec);
+	if(ec || !std::filesystem::is_directory(dir->real_path, ec)) {
+		return -1;
+	}
+
+	// Indexing reads the whole tree, done before taking the lock
+	if(build_index) {
+		dir->build_index();
+	}
+
+	auto lk = std::scoped_lock{allowed_files_mutex};
+	auto table = std::make_shared<allowed_files_table>(*allowed_files);
+
+	auto fd = preopen_fd_begin;
+	while(fd < preopen_fd_end && table->dirs.contains(fd) &&
+				table->dirs.at(fd)->virtual_path != virtual_path) {
+		++fd;
+	}
+	if(fd == preopen_fd_end) {
+		return -1;
+	}
 
-	virtual_file_map[std::string{virtual_path}] = fd;
+	dir->pseudo_file_descriptor = fd;
+	table->dirs[fd] = std::move(dir);
+	allowed_files = std::move(table);
 
 	return fd;
 }
 
+auto ecsact::wasm::detail::wasi::fs::prestat_dir_name(int32_t fd)
+	-> std::optional<std::string> {
+	auto dir = find_allowed_dir(fd);
+	if(!dir) {
+		return std::nullopt;
+	}
+
+	return dir->virtual_path;
+}
+
+auto ecsact::wasm::detail::wasi::fs::path_open(
+	fd_table&             table,
+	int32_t               dir_fd,
+	std::string_view      path,
+	ecsact_si_wasi_oflags oflags,
+	bool                  write,
+	int32_t&              out_fd
+) -> ecsact_si_wasi_errno {
+	auto open_dir = find_open(table, dir_fd);
+	if(!open_dir) {
+		return ecsact_si_wasi_errno::badf;
+	}
+
+	if(!open_dir->dir) {
+		return ecsact_si_wasi_errno::notdir;
+	}
+
+	auto modifying_oflags = ecsact_si_wasi_oflags::creat |
+		ecsact_si_wasi_oflags::trunc;
+	if(write || (oflags & modifying_oflags) != ecsact_si_wasi_oflags{}) {
+		return ecsact_si_wasi_errno::rofs;
+	}
+
+	auto dir = open_dir->dir;
+	auto rel_path = join_relative(open_dir->dir_path, path);
+	if(!rel_path) {
+		return ecsact_si_wasi_errno::notcapable;
+	}
+
+	auto entry = dir->find(*rel_path);
+	if(!entry) {
+		return ecsact_si_wasi_errno::noent;
+	}
+
+	auto is_dir = entry->type == ecsact_si_wasi_filetype::directory;
+	auto dir_only = ecsact_si_wasi_oflags::directory;
+	if(!is_dir && (oflags & dir_only) != ecsact_si_wasi_oflags{}) {
+		return ecsact_si_wasi_errno::notdir;
+	}
+
+	out_fd = table.next_fd++;
+	auto& open = table.open_files[out_fd];
+	if(is_dir) {
+		open.dir = std::move(dir);
+		open.dir_path = std::move(*rel_path);
+	} else {
+		open.file = std::move(entry->file);
+	}
+
+	return ecsact_si_wasi_errno::success;
+}
+
+auto ecsact::wasm::detail::wasi::fs::readdir(
+	fd_table&            table,
+	int32_t              dir_fd,
+	std::span<std::byte> out,
+	std::uint64_t        cookie,
+	std::uint32_t&       out_used
+) -> ecsact_si_wasi_errno {
+	auto open = find_open(table, dir_fd);
+	if(!open) {
+		return ecsact_si_wasi_errno::badf;
+	}
+
+	if(!open->dir) {
+		return ecsact_si_wasi_errno::notdir;
+	}
+
+	auto entries = open->dir->list(open->dir_path);
+	if(!entries) {
+		return ecsact_si_wasi_errno::noent;
+	}
+
+	auto used = std::size_t{};
+	auto append = [&](const void* data, std::size_t size) {
+		auto amount = std::min(size, out.size() - used);
+		std::memcpy(out.data() + used, data, amount);
+		used += amount;
+	};
+
+	for(auto i = cookie; entries->size() > i && out.size() > used; ++i) {
+		auto& [name, type] = (*entries)[i];
+		auto dirent = ecsact_si_wasi_dirent_t{
+			.d_next = i + 1,
+			.d_ino = 0,
+			.d_namlen = static_cast<std::uint32_t>(name.size()),
+			.d_type = type,
+		};
+		append(&dirent, sizeof(dirent));
+		append(name.data(), name.size());
+	}
+
+	out_used = static_cast<std::uint32_t>(used);
+	return ecsact_si_wasi_errno::success;
+}
+
 auto ecsact::wasm::detail::wasi::fs::real_path(int32_t fd) -> std::string {
-	if(!virtual_files.contains(fd)) {
+	auto file = find_allowed(fd);
+	if(!file) {
 		return "";
 	}
 
-	return virtual_files.at(fd).real_path;
+	return file->real_path;
 }
 
 auto ecsact::wasm::detail::wasi::fs::real_path(std::string_view virtual_path)
 	-> std::string {
-	const auto virtual_path_s = std::string{virtual_path};
-
-	auto itr = virtual_file_map.find(virtual_path_s);
-
-	if(itr != virtual_file_map.end()) {
-		return real_path(itr->second);
+	auto file = find_allowed(virtual_path);
+	if(!file) {
+		return "";
 	}
 
-	return "";
+	return file->real_path;
 }
 
-auto ecsact::wasm::detail::wasi::fs::fdstat(int32_t fd)
+auto ecsact::wasm::detail::wasi::fs::fdstat(fd_table& table, int32_t fd)
 	-> ecsact_si_wasi_fdstat_t {
-	if(!virtual_files.contains(fd)) {
+	auto open = find_open(table, fd);
+	if(!open) {
 		return {};
 	}
 
-	return virtual_files.at(fd).fdstat;
+	if(open->dir) {
+		return {
+			.fs_filetype = ecsact_si_wasi_filetype::directory,
+			.fs_flags = {},
+			.fs_rights_base = ecsact_si_wasi_rights::path_open |
+				ecsact_si_wasi_rights::fd_readdir |
+				ecsact_si_wasi_rights::fd_filestat_get,
+			.fs_rights_inheriting = ecsact_si_wasi_rights::fd_read |
+				ecsact_si_wasi_rights::fd_seek | ecsact_si_wasi_rights::fd_tell |
+				ecsact_si_wasi_rights::fd_filestat_get |
+				ecsact_si_wasi_rights::path_open | ecsact_si_wasi_rights::fd_readdir,
+		};
+	}
+
+	return open->file->fdstat;
 }
 
 auto ecsact::wasm::detail::wasi::fs::fdstat(std::string_view virtual_path)
 	-> ecsact_si_wasi_fdstat_t {
-	const auto virtual_path_s = std::string{virtual_path};
+	auto file = find_allowed(virtual_path);
+	if(!file) {
+		return {};
+	}
+
+	return file->fdstat;
+}
+
+auto ecsact::wasm::detail::wasi::fs::read(
+	fd_table&            table,
+	int32_t              pseudo_fd,
+	std::span<std::byte> out
+) -> std::optional<std::size_t> {
+	auto [open, contents] = find_contents(table, pseudo_fd);
+	if(!contents) {
+		return std::nullopt;
+	}
+
+	auto read_amount = copy_at(*contents, open->offset, out);
+	open->offset += read_amount;
 
-	auto itr = virtual_file_map.find(virtual_path_s);
+	return read_amount;
+}
+
+auto ecsact::wasm::detail::wasi::fs::write(
+	fd_table&                  table,
+	int32_t                    pseudo_fd,
+	std::span<const std::byte> data
+) -> bool {
+	auto open = find_open(table, pseudo_fd);
+	if(!open || !open->file || open->file->output_file_id == -1) {
+		return false;
+	}
 
-	if(itr != virtual_file_map.end()) {
-		return fdstat(itr->second);
+	// Dropped writes still succeed like dropped log writes. They are counted
+	// by the writer.
+	output_file_writer().append(open->file->output_file_id, data);
+	return true;
+}
+
+auto ecsact::wasm::detail::wasi::fs::pread(
+	fd_table&            table,
+	int32_t              pseudo_fd,
+	std::span<std::byte> out,
+	std::uint64_t        offset
+) -> std::optional<std::size_t> {
+	auto [open, contents] = find_contents(table, pseudo_fd);
+	if(!contents) {
+		return std::nullopt;
 	}
 
-	return {};
+	return copy_at(*contents, offset, out);
 }
 
-auto ecsact::wasm::detail::wasi::fs::ensure_open(int32_t pseudo_fd)
-	-> std::FILE* {
-	auto& info = virtual_files.at(pseudo_fd);
-	if(info.opened_file) {
-		return *info.opened_file;
+auto ecsact::wasm::detail::wasi::fs::seek(
+	fd_table&             table,
+	int32_t               pseudo_fd,
+	std::int64_t          offset,
+	ecsact_si_wasi_whence whence,
+	std::uint64_t&        out_new_offset
+) -> ecsact_si_wasi_errno {
+	auto [open, contents] = find_contents(table, pseudo_fd);
+	if(!contents) {
+		return ecsact_si_wasi_errno::badf;
+	}
+
+	auto base = std::int64_t{};
+	switch(whence) {
+		case ecsact_si_wasi_whence::set:
+			base = 0;
+			break;
+		case ecsact_si_wasi_whence::cur:
+			base = static_cast<std::int64_t>(open->offset);
+			break;
+		case ecsact_si_wasi_whence::end:
+			base = static_cast<std::int64_t>(contents->size());
+			break;
+		default:
+			return ecsact_si_wasi_errno::inval;
+	}
+
+	// Seeking past the end is allowed, reads from there return nothing. `base`
+	// is never negative so `base + offset` can't overflow for negative offsets.
+	if(offset < 0 ? base + offset < 0 : base > INT64_MAX - offset) {
+		return ecsact_si_wasi_errno::inval;
 	}
 
-	info.opened_file = std::fopen(info.real_path.c_str(), "r");
+	open->offset = static_cast<std::uint64_t>(base + offset);
+	out_new_offset = open->offset;
+	return ecsact_si_wasi_errno::success;
+}
+
+auto ecsact::wasm::detail::wasi::fs::tell(fd_table& table, int32_t pseudo_fd)
+	-> std::optional<std::uint64_t> {
+	auto open = find_open(table, pseudo_fd);
+	if(!open) {
+		return std::nullopt;
+	}
 
-	return *info.opened_file;
+	return open->offset;
 }
 
-auto ecsact::wasm::detail::wasi::fs::close(int32_t pseudo_fd) -> void {
-	auto& info = virtual_files.at(pseudo_fd);
-	if(info.opened_file) {
-		std::fclose(*info.opened_file);
-		info.opened_file = std::nullopt;
+auto ecsact::wasm::detail::wasi::fs::filestat(
+	fd_table& table,
+	int32_t   pseudo_fd
+) -> std::optional<ecsact_si_wasi_filestat_t> {
+	auto open_dir = find_open(table, pseudo_fd);
+	if(open_dir && open_dir->dir) {
+		return ecsact_si_wasi_filestat_t{
+			.filetype = ecsact_si_wasi_filetype::directory,
+			.nlink = 1,
+		};
 	}
+
+	auto [open, contents] = find_contents(table, pseudo_fd);
+	if(!contents) {
+		return std::nullopt;
+	}
+
+	return ecsact_si_wasi_filestat_t{
+		.dev = 0,
+		.ino = static_cast<std::uint64_t>(pseudo_fd),
+		.filetype = ecsact_si_wasi_filetype::regular_file,
+		.nlink = 1,
+		.size = contents->size(),
+		.atim = 0,
+		.mtim = 0,
+		.ctim = 0,
+	};
+}
+
+auto ecsact::wasm::detail::wasi::fs::close(fd_table& table, int32_t pseudo_fd)
+	-> void {
+	// The mapping stays with the allowed file for the next open. Preopens are
+	// looked up again on next use.
+	table.open_files.erase(pseudo_fd);
 }
@@ -1,21 +1,205 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
-#include <cstdio>
+#include <memory>
+#include <optional>
+#include <span>
 #include <string_view>
 #include <string>
+#include <unordered_map>
+#include <vector>
 #include "ecsact/si/wasmer/detail/wasi.hh"
 
 namespace ecsact::wasm::detail::wasi::fs {
+
+/**
+ * A file the host allowed guests to read. Immutable once registered and
+ * shared by every instance.
+ */
+class allowed_file;
+
+/**
+ * A real directory the host allowed guests to read as a preopen
+ */
+class allowed_dir;
+
+/**
+ * Preopened directories get the descriptors from `3` up to (excluding)
+ * `preopen_fd_end`, the range guests probe with `fd_prestat_get` at startup.
+ */
+constexpr auto preopen_fd_begin = int32_t{3};
+constexpr auto preopen_fd_end = int32_t{11};
+
+/**
+ * First descriptor handed out by `path_open`. Far above the descriptors of
+ * files allowed with `allow_file_read_access` so the two never collide.
+ */
+constexpr auto path_open_fd_begin = int32_t{1 << 24};
+
+/**
+ * A descriptor opened by one instance. Either a file or a directory inside
+ * a preopen.
+ */
+struct open_file {
+	std::shared_ptr<const allowed_file> file;
+	std::shared_ptr<const allowed_dir>  dir;
+
+	/**
+	 * Path of the directory relative to the preopen root
+	 */
+	std::string   dir_path;
+	std::uint64_t offset = 0;
+};
+
+/**
+ * Descriptors opened by a single instance. Instances are only ever used by
+ * one thread at a time so the table needs no synchronization and every
+ * instance has its own independent file offsets.
+ */
+struct fd_table {
+	std::unordered_map<int32_t, open_file> open_files;
+	int32_t                                next_fd = path_open_fd_begin;
+};
+
+/**
+ * Allows guests to read @p real_path as @p virtual_path. Safe to call while
+ * other threads read files, already opened descriptors are not affected.
+ *
+ * @returns the descriptor guests use for the file
+ */
 auto allow_file_read_access(
 	std::string_view real_path,
 	std::string_view virtual_path
 ) -> std::int32_t;
 
+/**
+ * Allows guests to read @p data as @p virtual_path. Every instance reads from
+ * the same buffer.
+ *
+ * @returns the descriptor guests use for the file
+ */
+auto allow_file_read_buffer(
+	std::string_view       virtual_path,
+	std::vector<std::byte> data
+) -> std::int32_t;
+
+/**
+ * Reads @p real_path into memory now and serves it like
+ * `allow_file_read_buffer`.
+ *
+ * @returns the descriptor guests use for the file or -1 if @p real_path is
+ *          not a regular file or could not be read
+ */
+auto preload_file(std::string_view real_path, std::string_view virtual_path)
+	-> std::int32_t;
+
+/**
+ * Creates (or truncates) @p real_path and allows guests to append to it as
+ * @p virtual_path. Writes are buffered and written to disk from a background
+ * thread (see `file_writer`.)
+ *
+ * @returns the descriptor guests use for the file or -1 if @p real_path could
+ *          not be opened for writing
+ */
+auto allow_file_write_access(
+	std::string_view real_path,
+	std::string_view virtual_path
+) -> std::int32_t;
+
+/**
+ * Allows guests to read everything below @p real_path through the preopened
+ * directory @p virtual_path. With @p build_index the directory tree is read
+ * once here so `path_open` and `fd_readdir` never touch the disk.
+ *
+ * @returns the preopen descriptor or -1 if @p real_path is not a directory or
+ *          all preopen descriptors are taken
+ */
+auto allow_dir_read_access(
+	std::string_view real_path,
+	std::string_view virtual_path,
+	bool             build_index
+) -> std::int32_t;
+
+auto prestat_dir_name(int32_t fd) -> std::optional<std::string>;
+
+/**
+ * Opens @p path relative to the directory @p dir_fd. Paths may not leave the
+ * preopen they are in. Only reading is allowed.
+ */
+auto path_open(
+	fd_table&             table,
+	int32_t               dir_fd,
+	std::string_view      path,
+	ecsact_si_wasi_oflags oflags,
+	bool                  write,
+	int32_t&              out_fd
+) -> ecsact_si_wasi_errno;
+
+/**
+ * Writes `ecsact_si_wasi_dirent_t` entries of @p dir_fd starting at
+ * @p cookie into @p out. The last entry is truncated if it does not fit.
+ */
+auto readdir(
+	fd_table&            table,
+	int32_t              dir_fd,
+	std::span<std::byte> out,
+	std::uint64_t        cookie,
+	std::uint32_t&       out_used
+) -> ecsact_si_wasi_errno;
+
 auto real_path(int32_t fd) -> std::string;
 auto real_path(std::string_view virtual_path) -> std::string;
-auto fdstat(int32_t fd) -> ecsact_si_wasi_fdstat_t;
+auto fdstat(fd_table& table, int32_t fd) -> ecsact_si_wasi_fdstat_t;
 auto fdstat(std::string_view virtual_path) -> ecsact_si_wasi_fdstat_t;
-auto ensure_open(int32_t pseudo_fd) -> std::FILE*;
-auto close(int32_t pseudo_fd) -> void;
+
+/**
+ * Copies from the current position of @p pseudo_fd into @p out and advances
+ * the position. Files are memory mapped once on first read.
+ *
+ * @returns bytes read or `std::nullopt` if @p pseudo_fd is not a readable file
+ */
+auto read(fd_table& table, int32_t pseudo_fd, std::span<std::byte> out)
+	-> std::optional<std::size_t>;
+
+/**
+ * Appends @p data to the output file @p pseudo_fd. Never waits on the disk.
+ * Data the writer has no room for is dropped (see
+ * `file_writer::dropped_bytes`.)
+ *
+ * @returns `false` if @p pseudo_fd is not a writable file
+ */
+auto write(
+	fd_table&                  table,
+	int32_t                    pseudo_fd,
+	std::span<const std::byte> data
+) -> bool;
+
+/**
+ * Like `read` but at @p offset and without moving the position
+ */
+auto pread(
+	fd_table&            table,
+	int32_t              pseudo_fd,
+	std::span<std::byte> out,
+	std::uint64_t        offset
+) -> std::optional<std::size_t>;
+
+auto seek(
+	fd_table&             table,
+	int32_t               pseudo_fd,
+	std::int64_t          offset,
+	ecsact_si_wasi_whence whence,
+	std::uint64_t&        out_new_offset
+) -> ecsact_si_wasi_errno;
+
+auto tell(fd_table& table, int32_t pseudo_fd) -> std::optional<std::uint64_t>;
+
+/**
+ * Only the type and size are meaningful, timestamps are always 0
+ */
+auto filestat(fd_table& table, int32_t pseudo_fd)
+	-> std::optional<ecsact_si_wasi_filestat_t>;
+
+auto close(fd_table& table, int32_t pseudo_fd) -> void;
 } // namespace ecsact::wasm::detail::wasi::fs
@@ -1,4 +1,11 @@
 #include "ecsact/si/wasm.h"
+#include "ecsact/si/wasmer/load_stats.h"
+#include "ecsact/si/wasmer/call_mem.h"
+#include "ecsact/si/wasmer/logging.h"
+#include "ecsact/si/wasmer/log_file.h"
+#include "ecsact/si/wasmer/fs.h"
+#include "ecsact/si/wasmer/clock.h"
+#include "ecsact/si/wasmer/environment.h"
 
 #include <map>
 #include <unordered_map>
@@ -23,32 +30,56 @@
 #include "ecsact/runtime/dynamic.h"
 #include "ecsact/si/wasmer/detail/minst/minst.hh"
 #include "ecsact/si/wasmer/detail/logger.hh"
+#include "ecsact/si/wasmer/detail/log_stream.hh"
+#include "ecsact/si/wasmer/detail/log_file_sink.hh"
+#include "ecsact/si/wasmer/detail/log_rate_limit.hh"
 #include "ecsact/si/wasmer/detail/wasi_fs.hh"
+#include "ecsact/si/wasmer/detail/wasi_clock.hh"
+#include "ecsact/si/wasmer/detail/wasi_env_vars.hh"
+#include "ecsact/si/wasmer/detail/file_writer.hh"
 #include "ecsact/si/wasmer/detail/globals.hh"
 #include "ecsact/si/wasmer/detail/guest_imports/wasi_snapshot_preview1.hh"
 #include "ecsact/si/wasmer/detail/guest_imports/env.hh"
 #include "ecsact/si/wasmer/detail/cpp_util.hh"
 #include "ecsact/si/wasmer/detail/mem_stack.hh"
+#include "ecsact/si/wasmer/detail/instance_env.hh"
+#include "ecsact/si/wasmer/detail/wasm_binary.hh"
+#include "ecsact/si/wasmer/detail/schema.hh"
 
 using namespace std::string_literals;
-using ecsact::wasm::detail::call_mem_alloc;
-using ecsact::wasm::detail::clear_log_lines;
-using ecsact::wasm::detail::consume_stdio_str_as_log_lines;
-using ecsact::wasm::detail::get_log_lines;
+using ecsact::wasm::detail::call_mem_invalid_offset;
+using ecsact::wasm::detail::call_mem_pop_frame;
+using ecsact::wasm::detail::call_mem_push_frame;
+using ecsact::wasm::detail::clear_log_rate_limits;
+using ecsact::wasm::detail::dropped_log_writes;
+using ecsact::wasm::detail::find_empty_exported_funcs;
 using ecsact::wasm::detail::guest_env_module_imports;
 using ecsact::wasm::detail::guest_wasi_module_imports;
+using ecsact::wasm::detail::instance_env;
+using ecsact::wasm::detail::log_file_sink;
+using ecsact::wasm::detail::log_line_entry;
+using ecsact::wasm::detail::log_stream;
 using ecsact::wasm::detail::minst;
 using ecsact::wasm::detail::minst_error;
 using ecsact::wasm::detail::minst_export;
 using ecsact::wasm::detail::minst_import;
 using ecsact::wasm::detail::minst_import_resolve_t;
-using ecsact::wasm::detail::set_call_mem_data;
-using ecsact::wasm::detail::start_transaction;
+using ecsact::wasm::detail::populate_action_cache;
+using ecsact::wasm::detail::populate_presence_mask;
+using ecsact::wasm::detail::populate_readonly_frame;
+using ecsact::wasm::detail::set_active_log_file_sink;
+using ecsact::wasm::detail::set_log_overflow_policy;
+using ecsact::wasm::detail::set_log_rate_limit;
+using ecsact::wasm::detail::set_log_ring_capacity;
+using ecsact::wasm::detail::system_capabilities;
+using ecsact::wasm::detail::take_log_lines;
 
 namespace {
 std::string last_error_message = "";
 
 struct minst_ecsact_system_impls {
+	// env must outlive minst since the guest imports hold a pointer to it
+	std::unique_ptr<instance_env>                           env;
 	minst                                                   minst;
 	std::unordered_map<ecsact_system_like_id, minst_export> sys_impl_exports;
 	minst_export                                            memory;
@@ -59,11 +90,13 @@ struct minst_ecsact_system_impls {
 	minst_ecsact_system_impls(minst_ecsact_system_impls&&) = default;
 
 	minst_ecsact_system_impls( //
+		std::unique_ptr<instance_env>                           env,
 		class minst&&                                           minst,
 		std::unordered_map<ecsact_system_like_id, minst_export> exports,
 		minst_export                                            memory
 	)
-		: minst(std::move(minst))
+		: env(std::move(env))
+		, minst(std::move(minst))
 		, sys_impl_exports(std::move(exports))
 		, memory(memory) {
 	}
@@ -74,6 +107,51 @@ auto trap_handler = ecsact_si_wasm_trap_handler{};
 auto all_minsts = std::vector<std::shared_ptr<minst_ecsact_system_impls>>{};
 auto next_available_minst_index = std::atomic_size_t{};
 
+auto log_stream_mutex = std::mutex{};
+auto active_log_stream = std::unique_ptr<log_stream>{};
+
+auto stop_log_stream() -> void {
+	auto lk = std::scoped_lock{log_stream_mutex};
+	active_log_stream.reset();
+}
+
+auto start_log_stream(
+	log_stream::deliver_fn_t deliver,
+	int32_t                  flush_interval_ms
+) -> void {
+	// The stream's last flush drains the logger statics in logger.cc. Handlers
+	// registered with atexit run before statics constructed earlier (all of
+	// them by now) are destroyed, while static destruction order across
+	// translation units is unspecified.
+	[[maybe_unused]] static auto stop_at_exit = std::atexit(stop_log_stream);
+
+	auto lk = std::scoped_lock{log_stream_mutex};
+	// Previous stream delivers its remaining lines before the new one starts
+	active_log_stream.reset();
+	active_log_stream = std::make_unique<log_stream>(
+		std::move(deliver),
+		std::chrono::milliseconds{std::max(flush_interval_ms, 1)}
+	);
+}
+
+auto to_log_record( //
+	const log_line_entry& entry
+) -> ecsact_si_wasmer_log_record {
+	return ecsact_si_wasmer_log_record{
+		.log_level = entry.log_level,
+		.message = entry.message.c_str(),
+		.message_length = static_cast<int32_t>(entry.message.size()),
+		.system_id = entry.attribution.system_id,
+		.entity = entry.attribution.entity,
+		.instance_index = entry.attribution.instance_index,
+		.thread_id = entry.attribution.thread_id,
+		.timestamp_ns = entry.attribution.timestamp_ns,
+	};
+}
+
+auto load_stats = ecsact_si_wasmer_load_stats{};
+auto elided_systems = std::vector<ecsact_system_like_id>{};
+
 thread_local auto thread_minst = std::weak_ptr<minst_ecsact_system_impls>{};
 
 auto ensure_minst() -> std::shared_ptr<minst_ecsact_system_impls> {
@@ -93,13 +171,96 @@ void ecsact_si_wasm_system_impl(ecsact_system_execution_context* ctx) {
 	auto itr = minst->sys_impl_exports.find(system_id);
 	assert(itr != minst->sys_impl_exports.end());
 
-	auto mem_data = std::array<std::byte, 4096>{};
-	set_call_mem_data(mem_data.data(), mem_data.size());
+	auto& env = *minst->env;
+	auto  frame = call_mem_push_frame();
+	auto  outer_guest_frames_base = env.guest_frames_base;
+	auto  outer_system_id = env.current_system_id;
+	auto  outer_entity = env.current_entity;
+	auto  outer_random_counter = env.random_counter;
+	env.guest_frames_base = env.guest_frames.size();
+	env.current_system_id = system_id;
+	env.current_entity = ecsact_system_execution_context_entity(ctx);
+	env.random_counter = 0;
 	defer {
-		set_call_mem_data(nullptr, 0);
+		env.current_system_id = outer_system_id;
+		env.current_entity = outer_entity;
+		env.random_counter = outer_random_counter;
+		env.guest_frames.resize(env.guest_frames_base);
+		env.guest_frames_base = outer_guest_frames_base;
+		env.ctx_handles.truncate(frame.offset);
+
+		auto high_water_mark = call_mem_pop_frame(frame);
+		auto& system_high_water_mark = env.call_mem_high_water_marks[system_id];
+		system_high_water_mark =
+			std::max(system_high_water_mark, high_water_mark);
+	};
+
+	// Nested impl calls on this thread share the outer call's handles
+	if(frame.depth == 0) {
+		env.ctx_handles.reset();
+	}
+
+	auto frame_itr = env.readonly_frames.find(system_id);
+	if(frame_itr != env.readonly_frames.end()) {
+		populate_readonly_frame(env, frame_itr->second, ctx);
+	}
+
+	auto action_itr = env.action_caches.find(system_id);
+	if(action_itr != env.action_caches.end()) {
+		populate_action_cache(env, action_itr->second, ctx);
+	}
+
+	auto mask_itr = env.presence_masks.find(system_id);
+	if(mask_itr != env.presence_masks.end()) {
+		populate_presence_mask(env, mask_itr->second, ctx);
+	}
+
+	auto ctx_handle = env.ctx_handles.get(ctx);
+	if(ctx_handle == call_mem_invalid_offset) {
+		if(trap_handler != nullptr) {
+			trap_handler(system_id, "call memory exhausted");
+		}
+		return;
+	}
+
+	auto trap = itr->second.func_call(ctx_handle);
+	if(trap && trap_handler != nullptr) {
+		trap_handler(system_id, trap->message().c_str());
+	}
+}
+
+/**
+ * Registered for systems whose exported impl has an empty body.
+ */
+void ecsact_si_wasm_noop_system_impl(ecsact_system_execution_context*) {
+}
+
+auto make_import_resolver(instance_env* env) -> minst::import_resolver_t {
+	return [env](const minst_import imp) -> minst_import_resolve_t {
+		auto method_name = imp.name();
+
+		if(imp.module() == "env") {
+			auto itr = guest_env_module_imports.find(method_name);
+			if(itr == guest_env_module_imports.end()) {
+				return std::nullopt;
+			}
+			auto resolve = itr->second();
+			resolve.env = env;
+			return resolve;
+		}
+
+		if(imp.module() == "wasi_snapshot_preview1") {
+			auto itr = guest_wasi_module_imports.find(method_name);
+			if(itr == guest_wasi_module_imports.end()) {
+				return std::nullopt;
+			}
+			auto resolve = itr->second();
+			resolve.env = env;
+			return resolve;
+		}
+
+		return std::nullopt;
 	};
-	call_mem_alloc(minst->memory.memory);
-	itr->second.func_call(call_mem_alloc(ctx));
 }
 
 auto get_system_impl_exports(
@@ -134,6 +295,38 @@ auto get_system_impl_exports(
 
 	return ECSACT_SI_WASM_OK;
 }
+
+/**
+ * Looks up the data and indexed field values size of every component the
+ * loaded systems have a capability for, filling the size caches of @p env.
+ * Host calls bounds check guest component pointers against these sizes.
+ *
+ * @returns `false` and sets `last_error_message` if a size is unknown
+ */
+auto cache_component_sizes(
+	instance_env&          env,
+	int                    systems_count,
+	ecsact_system_like_id* system_ids
+) -> bool {
+	for(auto i = 0; systems_count > i; ++i) {
+		auto capabilities = system_capabilities(system_ids[i]);
+		if(!capabilities) {
+			last_error_message = "ecsact meta module is not loaded";
+			return false;
+		}
+
+		for(auto& entry : *capabilities) {
+			if(!env.component_size(entry.component_id) ||
+				 !env.indexed_field_values_size(entry.component_id)) {
+				last_error_message = "unsupported field type in component " +
+					std::to_string(static_cast<int32_t>(entry.component_id));
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
 } // namespace
 
 void ecsact_si_wasm_last_error_message(
@@ -171,39 +364,27 @@ ecsact_si_wasm_error ecsact_si_wasm_load(
 		return ECSACT_SI_WASM_ERR_NO_SET_SYSTEM_EXECUTION;
 	}
 #endif
-	auto import_resolver = [&](const minst_import imp) -> minst_import_resolve_t {
-		auto method_name = imp.name();
-
-		if(imp.module() == "env") {
-			auto itr = guest_env_module_imports.find(method_name);
-			if(itr == guest_env_module_imports.end()) {
-				return std::nullopt;
-			}
-			return itr->second();
-		}
-
-		if(imp.module() == "wasi_snapshot_preview1") {
-			auto itr = guest_wasi_module_imports.find(method_name);
-			if(itr == guest_wasi_module_imports.end()) {
-				return std::nullopt;
-			}
-			return itr->second();
-		}
-
-		return std::nullopt;
-	};
 
 	all_minsts.clear();
 	all_minsts.reserve(100);
+	load_stats = {};
+	elided_systems.clear();
+
+	const auto empty_funcs = find_empty_exported_funcs(std::span{
+		reinterpret_cast<const std::byte*>(wasm_data),
+		static_cast<size_t>(wasm_data_size),
+	});
 
 	for(auto i = 0; 100 > i; ++i) {
+		auto env = std::make_unique<instance_env>();
+		env->index = i;
 		auto result = minst::create(
 			engine(),
 			std::span{
 				reinterpret_cast<std::byte*>(wasm_data),
 				static_cast<size_t>(wasm_data_size),
 			},
-			import_resolver
+			make_import_resolver(env.get())
 		);
 
 		if(std::holds_alternative<minst_error>(result)) {
@@ -221,6 +402,10 @@ ecsact_si_wasm_error ecsact_si_wasm_load(
 			}
 		}
 
+		if(!cache_component_sizes(*env, systems_count, system_ids)) {
+			return ECSACT_SI_WASM_ERR_INSTANTIATE_FAIL;
+		}
+
 		auto& inst = std::get<minst>(result);
 		auto  system_impl_exports =
 			std::unordered_map<ecsact_system_like_id, minst_export>{};
@@ -247,12 +432,12 @@ ecsact_si_wasm_error ecsact_si_wasm_load(
 		}
 
 		assert(wasm_mem);
+		env->store = inst.store();
+		env->memory = wasm_mem->memory;
 
-		auto mem_data = std::array<std::byte, 4096>{};
-		set_call_mem_data(mem_data.data(), mem_data.size());
-		call_mem_alloc<wasm_memory_t*>(wasm_mem->memory);
+		auto init_frame = call_mem_push_frame();
 		defer {
-			set_call_mem_data(nullptr, 0);
+			call_mem_pop_frame(init_frame);
 		};
 		auto init_trap = inst.initialize();
 		if(init_trap) {
@@ -260,6 +445,7 @@ ecsact_si_wasm_error ecsact_si_wasm_load(
 		}
 
 		all_minsts.emplace_back(std::make_shared<minst_ecsact_system_impls>( //
+			std::move(env),
 			std::move(inst),
 			system_impl_exports,
 			*wasm_mem
@@ -267,12 +453,26 @@ ecsact_si_wasm_error ecsact_si_wasm_load(
 	}
 
 	for(auto i = 0; systems_count > i; ++i) {
+		if(empty_funcs.contains(wasm_exports[i])) {
+			elided_systems.push_back(system_ids[i]);
+			ecsact_set_system_execution_impl(
+				system_ids[i],
+				&ecsact_si_wasm_noop_system_impl
+			);
+			continue;
+		}
+
 		ecsact_set_system_execution_impl(
 			system_ids[i],
 			&ecsact_si_wasm_system_impl
 		);
 	}
 
+	load_stats.instances_count = static_cast<int32_t>(all_minsts.size());
+	load_stats.systems_count = systems_count;
+	load_stats.elided_systems_count =
+		static_cast<int32_t>(elided_systems.size());
+
 	return ECSACT_SI_WASM_OK;
 }
 
@@ -320,14 +520,45 @@ void ecsact_si_wasm_unload(
 void ecsact_si_wasm_reset() {
 	all_minsts.clear();
 	next_available_minst_index = 0;
+	load_stats = {};
+	elided_systems.clear();
+}
+
+void ecsact_si_wasmer_get_load_stats(ecsact_si_wasmer_load_stats* out_stats) {
+	*out_stats = load_stats;
+}
+
+int32_t ecsact_si_wasmer_call_mem_high_water_mark( //
+	ecsact_system_like_id system_id
+) {
+	auto high_water_mark = std::size_t{};
+	for(auto& minst : all_minsts) {
+		auto& marks = minst->env->call_mem_high_water_marks;
+		auto  itr = marks.find(system_id);
+		if(itr != marks.end()) {
+			high_water_mark = std::max(high_water_mark, itr->second);
+		}
+	}
+
+	return static_cast<int32_t>(high_water_mark);
+}
+
+void ecsact_si_wasmer_get_elided_systems(
+	int32_t                max_system_ids,
+	ecsact_system_like_id* out_system_ids
+) {
+	std::copy_n(
+		elided_systems.begin(),
+		std::min(max_system_ids, static_cast<int32_t>(elided_systems.size())),
+		out_system_ids
+	);
 }
 
 void ecsact_si_wasm_consume_logs(
 	ecsact_si_wasm_log_consumer consumer,
 	void*                       consumer_user_data
 ) {
-	auto t = start_transaction();
-	for(auto& entry : get_log_lines(t)) {
+	for(auto& entry : take_log_lines()) {
 		consumer(
 			entry.log_level,
 			entry.message.c_str(),
@@ -335,17 +566,113 @@ void ecsact_si_wasm_consume_logs(
 			consumer_user_data
 		);
 	}
+}
 
-	for(auto& entry : consume_stdio_str_as_log_lines(t)) {
-		consumer(
-			entry.log_level,
-			entry.message.c_str(),
-			static_cast<int32_t>(entry.message.size()),
-			consumer_user_data
-		);
+void ecsact_si_wasmer_consume_log_records(
+	ecsact_si_wasmer_log_record_consumer consumer,
+	void*                                consumer_user_data
+) {
+	for(auto& entry : take_log_lines()) {
+		auto record = to_log_record(entry);
+		consumer(&record, consumer_user_data);
+	}
+}
+
+void ecsact_si_wasmer_start_log_stream(
+	ecsact_si_wasm_log_consumer consumer,
+	void*                       consumer_user_data,
+	int32_t                     flush_interval_ms
+) {
+	start_log_stream(
+		[=](const log_line_entry& entry) {
+			consumer(
+				entry.log_level,
+				entry.message.c_str(),
+				static_cast<int32_t>(entry.message.size()),
+				consumer_user_data
+			);
+		},
+		flush_interval_ms
+	);
+}
+
+void ecsact_si_wasmer_start_log_record_stream(
+	ecsact_si_wasmer_log_record_consumer consumer,
+	void*                                consumer_user_data,
+	int32_t                              flush_interval_ms
+) {
+	start_log_stream(
+		[=](const log_line_entry& entry) {
+			auto record = to_log_record(entry);
+			consumer(&record, consumer_user_data);
+		},
+		flush_interval_ms
+	);
+}
+
+void ecsact_si_wasmer_stop_log_stream() {
+	stop_log_stream();
+}
+
+int32_t ecsact_si_wasmer_open_log_file(const char* path, int64_t capacity) {
+	if(path == nullptr || capacity <= 0) {
+		return -1;
+	}
+
+	auto sink = log_file_sink::open(path, static_cast<size_t>(capacity));
+	if(!sink) {
+		return -1;
 	}
 
-	clear_log_lines(t);
+	set_active_log_file_sink(std::move(sink));
+	return 0;
+}
+
+void ecsact_si_wasmer_close_log_file() {
+	set_active_log_file_sink(nullptr);
+}
+
+void ecsact_si_wasmer_set_log_rate_limit(
+	ecsact_system_like_id    system_id,
+	ecsact_si_wasm_log_level level,
+	int32_t                  max_lines_per_second,
+	int32_t                  sample_every
+) {
+	set_log_rate_limit(
+		system_id,
+		level,
+		ecsact::wasm::detail::log_rate_limit{
+			.max_lines_per_second = std::max(max_lines_per_second, 0),
+			.sample_every = std::max(sample_every, 1),
+		}
+	);
+}
+
+void ecsact_si_wasmer_clear_log_rate_limits() {
+	clear_log_rate_limits();
+}
+
+void ecsact_si_wasmer_set_log_overflow_policy(
+	ecsact_si_wasmer_log_overflow_policy policy
+) {
+	using ecsact::wasm::detail::log_overflow_policy;
+
+	switch(policy) {
+		case ECSACT_SI_WASMER_LOG_OVERFLOW_DROP_NEWEST:
+			set_log_overflow_policy(log_overflow_policy::drop_newest);
+			break;
+		case ECSACT_SI_WASMER_LOG_OVERFLOW_DROP_OLDEST:
+			set_log_overflow_policy(log_overflow_policy::drop_oldest);
+			break;
+	}
+}
+
+void ecsact_si_wasmer_set_log_buffer_size(int32_t buffer_size) {
+	set_log_ring_capacity(static_cast<std::size_t>(std::max(buffer_size, 0)));
+}
+
+int64_t ecsact_si_wasmer_dropped_log_writes_count() {
+	return static_cast<int64_t>(dropped_log_writes());
 }
 
 int32_t ecsact_si_wasm_allow_file_read_access(
@@ -365,3 +692,114 @@ int32_t ecsact_si_wasm_allow_file_read_access(
 		}
 	);
 }
+
+int32_t ecsact_si_wasmer_allow_dir_read_access(
+	const char* real_dir_path,
+	const char* virtual_dir_path,
+	int32_t     build_index
+) {
+	if(real_dir_path == nullptr || virtual_dir_path == nullptr) {
+		return -1;
+	}
+
+	return ecsact::wasm::detail::wasi::fs::allow_dir_read_access(
+		real_dir_path,
+		virtual_dir_path,
+		build_index != 0
+	);
+}
+
+int32_t ecsact_si_wasmer_allow_file_write_access(
+	const char* real_file_path,
+	const char* virtual_file_path
+) {
+	if(real_file_path == nullptr || virtual_file_path == nullptr) {
+		return -1;
+	}
+
+	return ecsact::wasm::detail::wasi::fs::allow_file_write_access(
+		real_file_path,
+		virtual_file_path
+	);
+}
+
+void ecsact_si_wasmer_flush_written_files() {
+	ecsact::wasm::detail::output_file_writer().flush();
+}
+
+int64_t ecsact_si_wasmer_dropped_written_bytes_count() {
+	return static_cast<int64_t>(
+		ecsact::wasm::detail::output_file_writer().dropped_bytes()
+	);
+}
+
+int32_t ecsact_si_wasmer_allow_file_read_buffer(
+	const char* virtual_file_path,
+	const void* data,
+	int64_t     size
+) {
+	if(virtual_file_path == nullptr || size < 0 || (size > 0 && !data)) {
+		return -1;
+	}
+
+	auto bytes = static_cast<const std::byte*>(data);
+	return ecsact::wasm::detail::wasi::fs::allow_file_read_buffer(
+		virtual_file_path,
+		std::vector<std::byte>(bytes, bytes + size)
+	);
+}
+
+int32_t ecsact_si_wasmer_preload_file(
+	const char* real_file_path,
+	const char* virtual_file_path
+) {
+	if(real_file_path == nullptr || virtual_file_path == nullptr) {
+		return -1;
+	}
+
+	return ecsact::wasm::detail::wasi::fs::preload_file(
+		real_file_path,
+		virtual_file_path
+	);
+}
+
+void ecsact_si_wasmer_enable_deterministic_mode(
+	int64_t  tick_duration_ns,
+	uint64_t seed
+) {
+	ecsact::wasm::detail::wasi::clock::enable_deterministic(
+		tick_duration_ns,
+		seed
+	);
+}
+
+void ecsact_si_wasmer_disable_deterministic_mode() {
+	ecsact::wasm::detail::wasi::clock::disable_deterministic();
+}
+
+void ecsact_si_wasmer_advance_deterministic_clock(int64_t ticks) {
+	ecsact::wasm::detail::wasi::clock::advance_ticks(ticks);
+}
+
+int32_t ecsact_si_wasmer_set_environment(
+	const char* const* vars,
+	int32_t            vars_count
+) {
+	if(vars_count > 0 && vars == nullptr) {
+		return -1;
+	}
+
+	auto env_vars = std::vector<std::string>{};
+	env_vars.reserve(std::max(vars_count, 0));
+	for(auto i = 0; vars_count > i; ++i) {
+		auto var = std::string_view{vars[i] ? vars[i] : ""};
+		auto separator = var.find('=');
+		if(separator == 0 || separator == std::string_view::npos) {
+			return -1;
+		}
+		env_vars.emplace_back(var);
+	}
+
+	ecsact::wasm::detail::wasi::env_vars::set_environment(env_vars);
+	return 0;
+}
@@ -0,0 +1,204 @@
+#include "ecsact/si/wasmer/detail/wasm_binary.hh"
+
+#include <algorithm>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+constexpr auto wasm_magic = std::uint32_t{0x6D736100};
+constexpr auto wasm_version = std::uint32_t{1};
+
+constexpr auto import_section_id = std::uint8_t{2};
+constexpr auto export_section_id = std::uint8_t{7};
+constexpr auto code_section_id = std::uint8_t{10};
+
+constexpr auto extern_kind_func = std::uint8_t{0};
+constexpr auto extern_kind_table = std::uint8_t{1};
+constexpr auto extern_kind_memory = std::uint8_t{2};
+constexpr auto extern_kind_global = std::uint8_t{3};
+
+constexpr auto opcode_end = std::uint8_t{0x0B};
+
+struct reader {
+	std::span<const std::byte> data;
+	std::size_t                offset = 0;
+	bool                       failed = false;
+
+	auto remaining() const -> std::size_t {
+		return failed ? 0 : data.size() - offset;
+	}
+
+	auto byte() -> std::uint8_t {
+		if(remaining() < 1) {
+			failed = true;
+			return 0;
+		}
+		return static_cast<std::uint8_t>(data[offset++]);
+	}
+
+	auto u32_fixed() -> std::uint32_t {
+		auto result = std::uint32_t{};
+		for(auto i = 0; 4 > i; ++i) {
+			result |= static_cast<std::uint32_t>(byte()) << (i * 8);
+		}
+		return result;
+	}
+
+	auto u32() -> std::uint32_t {
+		auto result = std::uint32_t{};
+		for(auto shift = 0; 35 > shift; shift += 7) {
+			auto b = byte();
+			result |= static_cast<std::uint32_t>(b & 0x7F) << shift;
+			if((b & 0x80) == 0) {
+				return result;
+			}
+		}
+		failed = true;
+		return 0;
+	}
+
+	auto bytes(std::size_t count) -> std::span<const std::byte> {
+		if(remaining() < count) {
+			failed = true;
+			return {};
+		}
+		auto result = data.subspan(offset, count);
+		offset += count;
+		return result;
+	}
+
+	auto name() -> std::string_view {
+		auto name_bytes = bytes(u32());
+		return {
+			reinterpret_cast<const char*>(name_bytes.data()),
+			name_bytes.size(),
+		};
+	}
+
+	auto skip_limits() -> void {
+		auto flags = byte();
+		u32();
+		if(flags & 0x01) {
+			u32();
+		}
+	}
+};
+
+auto count_imported_funcs(reader r) -> std::optional<std::uint32_t> {
+	auto funcs_count = std::uint32_t{};
+	auto imports_count = r.u32();
+	for(auto i = 0u; imports_count > i && !r.failed; ++i) {
+		r.name();
+		r.name();
+		switch(r.byte()) {
+			case extern_kind_func:
+				r.u32();
+				funcs_count += 1;
+				break;
+			case extern_kind_table:
+				r.byte();
+				r.skip_limits();
+				break;
+			case extern_kind_memory:
+				r.skip_limits();
+				break;
+			case extern_kind_global:
+				r.byte();
+				r.byte();
+				break;
+			default:
+				return std::nullopt;
+		}
+	}
+
+	if(r.failed) {
+		return std::nullopt;
+	}
+	return funcs_count;
+}
+
+auto is_empty_func_body(reader body) -> bool {
+	auto local_decls_count = body.u32();
+	for(auto i = 0u; local_decls_count > i && !body.failed; ++i) {
+		body.u32();
+		body.byte();
+	}
+
+	return !body.failed && body.remaining() == 1 && body.byte() == opcode_end;
+}
+} // namespace
+
+auto ecsact::wasm::detail::find_empty_exported_funcs( //
+	std::span<const std::byte> wasm_data
+) -> std::unordered_set<std::string> {
+	auto r = reader{wasm_data};
+	if(r.u32_fixed() != wasm_magic || r.u32_fixed() != wasm_version) {
+		return {};
+	}
+
+	auto imported_funcs_count = std::uint32_t{};
+	auto exported_funcs = std::unordered_map<std::uint32_t, std::string_view>{};
+	auto code_bodies = std::vector<std::span<const std::byte>>{};
+
+	while(r.remaining() > 0) {
+		auto section_id = r.byte();
+		auto section = reader{r.bytes(r.u32())};
+		if(r.failed) {
+			return {};
+		}
+
+		if(section_id == import_section_id) {
+			auto count = count_imported_funcs(section);
+			if(!count) {
+				return {};
+			}
+			imported_funcs_count = *count;
+		} else if(section_id == export_section_id) {
+			auto exports_count = section.u32();
+			for(auto i = 0u; exports_count > i && !section.failed; ++i) {
+				auto export_name = section.name();
+				auto kind = section.byte();
+				auto index = section.u32();
+				if(kind == extern_kind_func) {
+					exported_funcs.emplace(index, export_name);
+				}
+			}
+		} else if(section_id == code_section_id) {
+			auto bodies_count = section.u32();
+			// Every body takes at least one byte, don't trust the count further
+			code_bodies.reserve(
+				std::min<std::size_t>(bodies_count, section.remaining())
+			);
+			for(auto i = 0u; bodies_count > i && !section.failed; ++i) {
+				code_bodies.emplace_back(section.bytes(section.u32()));
+			}
+		}
+
+		if(section.failed) {
+			return {};
+		}
+	}
+
+	auto empty_funcs = std::unordered_set<std::string>{};
+	for(auto&& [func_index, export_name] : exported_funcs) {
+		// Imported functions occupy the start of the function index space and
+		// have no body
+		if(func_index < imported_funcs_count) {
+			continue;
+		}
+
+		auto body_index = func_index - imported_funcs_count;
+		if(body_index >= code_bodies.size()) {
+			continue;
+		}
+
+		if(is_empty_func_body(reader{code_bodies[body_index]})) {
+			empty_funcs.emplace(export_name);
+		}
+	}
+
+	return empty_funcs;
+}
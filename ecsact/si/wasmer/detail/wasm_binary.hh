@@ -0,0 +1,20 @@
+#pragma once
+
+#include <cstddef>
+#include <span>
+#include <string>
+#include <unordered_set>
+
+namespace ecsact::wasm::detail {
+
+/**
+ * Scans the export and code sections of @p wasm_data and returns the names of
+ * exported functions whose body has no instructions (only the final `end`.)
+ * Calling such a function is provably a no-op. Returns an empty set if
+ * @p wasm_data is not a well formed module.
+ */
+auto find_empty_exported_funcs( //
+	std::span<const std::byte> wasm_data
+) -> std::unordered_set<std::string>;
+
+} // namespace ecsact::wasm::detail
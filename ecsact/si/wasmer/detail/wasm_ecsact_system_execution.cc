@@ -1,43 +1,41 @@
 #include "ecsact/si/wasmer/detail/wasm_ecsact_system_execution.h"
 
+#include <algorithm>
 #include <cassert>
 #include <iostream>
+#include <limits>
+#include <string>
 #include <unordered_map>
 #include <vector>
 #include "ecsact/runtime/dynamic.h"
 #include "ecsact/si/wasmer/detail/mem_stack.hh"
+#include "ecsact/si/wasmer/detail/instance_env.hh"
+#include "ecsact/si/wasmer/detail/schema.hh"
 
-using ecsact::wasm::detail::call_mem_alloc;
+using ecsact::wasm::detail::action_cache;
+using ecsact::wasm::detail::call_mem_invalid_offset;
+using ecsact::wasm::detail::call_mem_pop_frame;
+using ecsact::wasm::detail::call_mem_push_frame;
 using ecsact::wasm::detail::debug_trace_method;
+using ecsact::wasm::detail::get_instance_env;
+using ecsact::wasm::detail::instance_env;
+using ecsact::wasm::detail::presence_mask;
+using ecsact::wasm::detail::readonly_frame;
+using ecsact::wasm::detail::system_capability;
 
 namespace {
 
+/**
+ * Reads the execution context behind a guest context handle. Returns `nullptr`
+ * for invalid handles and the null handle.
+ */
 auto get_execution_context( //
 	const wasm_val_t& val
 ) -> ecsact_system_execution_context* {
 	assert(val.kind == WASM_I32);
-	return ecsact::wasm::detail::call_mem_read<ecsact_system_execution_context*>(
-		val.of.i32
-	);
-}
-
-auto get_const_execution_context( //
-	const wasm_val_t& val
-) -> const ecsact_system_execution_context* {
-	assert(val.kind == WASM_I32);
-	return ecsact::wasm::detail::call_mem_read<
-		const ecsact_system_execution_context*>(val.of.i32);
-}
-
-auto get_execution_context_memory( //
-	const wasm_val_t& val
-) -> wasm_memory_t* {
-	assert(val.kind == WASM_I32);
-	// wasm memory is always allocated right before the execution context
-	return ecsact::wasm::detail::call_mem_read<wasm_memory_t*>(
-		val.of.i32 -
-		sizeof(ecsact_system_execution_context*) // NOLINT(bugprone-sizeof-expression)
-	);
+	auto ctx = ecsact::wasm::detail::call_mem_read<
+		ecsact_system_execution_context*>(val.of.i32);
+	return ctx ? *ctx : nullptr;
 }
 
 template<typename EcsactID>
@@ -46,134 +44,323 @@ EcsactID ecsact_id_from_wasm_i32(const wasm_val_t& val) {
 	return static_cast<EcsactID>(val.of.i32);
 }
 
-void* get_void_ptr(const wasm_val_t& val, wasm_memory_t* memory) {
-	assert(val.kind == WASM_I32);
-	if(val.of.i32 == 0) {
-		return nullptr;
+/**
+ * Translates the guest pointer arguments of a single host call. Null guest
+ * pointers become `nullptr`. Pointers outside of the guest memory set
+ * `out_of_bounds` so the host call can trap before calling into the runtime.
+ */
+struct guest_ptr_args {
+	instance_env& env;
+	bool          out_of_bounds = false;
+
+	template<typename T = void>
+	auto get(std::int32_t guest_ptr, std::size_t count = 1) -> T* {
+		if(guest_ptr == 0) {
+			return nullptr;
+		}
+
+		auto ptr = env.guest_cast<T>(guest_ptr, count);
+		if(ptr == nullptr) {
+			out_of_bounds = true;
+		}
+		return ptr;
+	}
+
+	template<typename T = void>
+	auto get(const wasm_val_t& val, std::size_t count = 1) -> T* {
+		assert(val.kind == WASM_I32);
+		return get<T>(val.of.i32, count);
+	}
+
+	/**
+	 * Same as `get` for a pointer the runtime reads or writes @p component_id
+	 * data through. The whole component must lie
+	 * inside the guest memory. `ecsact_si_wasm_load` makes sure the size of
+	 * every component a loaded system has a capability for is known, for any
+	 * other component only the first byte is checked.
+	 */
+	template<typename T = void>
+	auto get_component(
+		ecsact_component_like_id component_id,
+		std::int32_t             guest_ptr
+	) -> T* {
+		if(guest_ptr == 0) {
+			return nullptr;
+		}
+
+		auto size = env.component_size(component_id);
+		return get<T>(guest_ptr, size.value_or(1));
+	}
+
+	template<typename T = void>
+	auto get_component(
+		ecsact_component_like_id component_id,
+		const wasm_val_t&        val
+	) -> T* {
+		assert(val.kind == WASM_I32);
+		return get_component<T>(component_id, val.of.i32);
+	}
+
+	/**
+	 * Same as `get_component` for a pointer to the indexed field values of
+	 * @p component_id, which are smaller than the component data.
+	 */
+	template<typename T = void>
+	auto get_indexed_fields(
+		ecsact_component_like_id component_id,
+		std::int32_t             guest_ptr
+	) -> T* {
+		if(guest_ptr == 0) {
+			return nullptr;
+		}
+
+		auto size = env.indexed_field_values_size(component_id);
+		return get<T>(guest_ptr, size.value_or(1));
+	}
+
+	template<typename T = void>
+	auto get_indexed_fields(
+		ecsact_component_like_id component_id,
+		const wasm_val_t&        val
+	) -> T* {
+		assert(val.kind == WASM_I32);
+		return get_indexed_fields<T>(component_id, val.of.i32);
+	}
+
+	/**
+	 * Same as `get_execution_context` except invalid handles also set
+	 * `out_of_bounds`.
+	 */
+	auto ctx(const wasm_val_t& val) -> ecsact_system_execution_context* {
+		auto ctx = get_execution_context(val);
+		if(ctx == nullptr) {
+			out_of_bounds = true;
+		}
+		return ctx;
+	}
+};
+
+/**
+ * What a guest pointer to a component points at
+ */
+enum class component_ptr_kind {
+	data,
+	indexed_fields,
+};
+
+/**
+ * Bounds checks every guest pointer in a guest array of component data (or
+ * indexed field values) pointers against the size of the matching component
+ * in @p component_ids. Used by the `*_many` imports so a bad pointer traps
+ * before any component is touched. A null @p guest_ptr_array is allowed, null
+ * @p component_ids are not unless @p count is 0.
+ */
+auto guest_ptr_array_in_bounds(
+	guest_ptr_args&                 ptrs,
+	component_ptr_kind              kind,
+	const ecsact_component_like_id* component_ids,
+	const std::int32_t*             guest_ptr_array,
+	std::int32_t                    count
+) -> bool {
+	if(component_ids == nullptr && count > 0) {
+		ptrs.out_of_bounds = true;
+		return false;
+	}
+
+	if(guest_ptr_array == nullptr) {
+		return true;
 	}
 
-	auto mem_bytes = wasm_memory_data(memory);
-	// the i32 val is an index of the wasm memory data
-	return mem_bytes + val.of.i32;
+	for(auto i = 0; count > i; ++i) {
+		if(kind == component_ptr_kind::indexed_fields) {
+			ptrs.get_indexed_fields(component_ids[i], guest_ptr_array[i]);
+		} else {
+			ptrs.get_component(component_ids[i], guest_ptr_array[i]);
+		}
+	}
+
+	return !ptrs.out_of_bounds;
 }
 
-const void* get_const_void_ptr(const wasm_val_t& val, wasm_memory_t* memory) {
-	assert(val.kind == WASM_I32);
-	if(val.of.i32 == 0) {
-		return nullptr;
+/**
+ * Translates a guest array of component data pointers into the instance's
+ * scratch buffer so the generate host calls don't allocate per call.
+ * Pointers must already be bounds checked.
+ */
+auto translate_components_data(
+	instance_env&              env,
+	guest_ptr_args&            ptrs,
+	const ecsact_component_id* component_ids,
+	const std::int32_t*        guest_ptr_array,
+	std::int32_t               count
+) -> const void** {
+	auto& components_data = env.components_data_scratch;
+	if(components_data.size() < static_cast<std::size_t>(count)) {
+		components_data.resize(count);
+	}
+
+	for(auto i = 0; count > i; ++i) {
+		components_data[i] =
+			ptrs.get_component<const void>(component_ids[i], guest_ptr_array[i]);
 	}
 
-	auto mem_bytes = wasm_memory_data(memory);
-	// the i32 val is an index of the wasm memory data
-	return mem_bytes + val.of.i32;
+	return components_data.data();
 }
 
 } // namespace
 
 wasm_trap_t* wasm_ecsact_system_execution_context_action(
+	void*                 env,
 	const wasm_val_vec_t* args,
 	wasm_val_vec_t*       results
 ) {
 	debug_trace_method("ecsact_system_execution_context_action");
 
-	auto ctx = get_execution_context(args->data[0]);
-	auto memory = get_execution_context_memory(args->data[0]);
+	auto& inst_env = get_instance_env(env);
+	auto  ptrs = guest_ptr_args{inst_env};
+	auto  ctx = ptrs.ctx(args->data[0]);
+	auto  out_action_data = ptrs.get(args->data[1]);
 
-	ecsact_system_execution_context_action(
-		ctx,
-		get_void_ptr(args->data[1], memory)
-	);
+	if(ptrs.out_of_bounds) {
+		return inst_env.out_of_bounds_trap( //
+			"ecsact_system_execution_context_action"
+		);
+	}
+
+	ecsact_system_execution_context_action(ctx, out_action_data);
 
 	return nullptr;
 }
 
 wasm_trap_t* wasm_ecsact_system_execution_context_add(
+	void*                 env,
 	const wasm_val_vec_t* args,
 	wasm_val_vec_t*       results
 ) {
 	debug_trace_method("ecsact_system_execution_context_add");
 
-	auto ctx = get_execution_context(args->data[0]);
-	auto memory = get_execution_context_memory(args->data[0]);
+	auto& inst_env = get_instance_env(env);
+	auto  ptrs = guest_ptr_args{inst_env};
+	auto  ctx = ptrs.ctx(args->data[0]);
+	auto  component_id =
+		ecsact_id_from_wasm_i32<ecsact_component_like_id>(args->data[1]);
+	auto component_data =
+		ptrs.get_component<const void>(component_id, args->data[2]);
 
-	ecsact_system_execution_context_add(
-		ctx,
-		ecsact_id_from_wasm_i32<ecsact_component_like_id>(args->data[1]),
-		get_const_void_ptr(args->data[2], memory)
-	);
+	if(ptrs.out_of_bounds) {
+		return inst_env.out_of_bounds_trap("ecsact_system_execution_context_add");
+	}
+
+	ecsact_system_execution_context_add(ctx, component_id, component_data);
 
 	return nullptr;
 }
 
 wasm_trap_t* wasm_ecsact_system_execution_context_remove(
+	void*                 env,
 	const wasm_val_vec_t* args,
 	wasm_val_vec_t*       results
 ) {
 	debug_trace_method("ecsact_system_execution_context_remove");
 
-	auto ctx = get_execution_context(args->data[0]);
-	auto memory = get_execution_context_memory(args->data[0]);
+	auto& inst_env = get_instance_env(env);
+	auto  ptrs = guest_ptr_args{inst_env};
+	auto  ctx = ptrs.ctx(args->data[0]);
+	auto  component_id =
+		ecsact_id_from_wasm_i32<ecsact_component_like_id>(args->data[1]);
+	auto indexed_fields = ptrs.get_indexed_fields(component_id, args->data[2]);
 
-	ecsact_system_execution_context_remove(
-		ctx,
-		ecsact_id_from_wasm_i32<ecsact_component_like_id>(args->data[1]),
-		get_void_ptr(args->data[2], memory)
-	);
+	if(ptrs.out_of_bounds) {
+		return inst_env.out_of_bounds_trap( //
+			"ecsact_system_execution_context_remove"
+		);
+	}
+
+	ecsact_system_execution_context_remove(ctx, component_id, indexed_fields);
 	return nullptr;
 }
 
 wasm_trap_t* wasm_ecsact_system_execution_context_get(
+	void*                 env,
 	const wasm_val_vec_t* args,
 	wasm_val_vec_t*       results
 ) {
 	debug_trace_method("ecsact_system_execution_context_get");
 
-	auto ctx = get_execution_context(args->data[0]);
-	auto memory = get_execution_context_memory(args->data[0]);
+	auto& inst_env = get_instance_env(env);
+	auto  ptrs = guest_ptr_args{inst_env};
+	auto  ctx = ptrs.ctx(args->data[0]);
+	auto  component_id =
+		ecsact_id_from_wasm_i32<ecsact_component_like_id>(args->data[1]);
+	auto out_component_data = ptrs.get_component(component_id, args->data[2]);
+	auto indexed_fields = ptrs.get_indexed_fields(component_id, args->data[3]);
+
+	if(ptrs.out_of_bounds) {
+		return inst_env.out_of_bounds_trap("ecsact_system_execution_context_get");
+	}
 
 	ecsact_system_execution_context_get(
 		ctx,
-		ecsact_id_from_wasm_i32<ecsact_component_like_id>(args->data[1]),
-		get_void_ptr(args->data[2], memory),
-		get_void_ptr(args->data[3], memory)
+		component_id,
+		out_component_data,
+		indexed_fields
 	);
 
 	return nullptr;
 }
 
 wasm_trap_t* wasm_ecsact_system_execution_context_update(
+	void*                 env,
 	const wasm_val_vec_t* args,
 	wasm_val_vec_t*       results
 ) {
 	debug_trace_method("ecsact_system_execution_context_update");
 
-	auto ctx = get_execution_context(args->data[0]);
-	auto memory = get_execution_context_memory(args->data[0]);
+	auto& inst_env = get_instance_env(env);
+	auto  ptrs = guest_ptr_args{inst_env};
+	auto  ctx = ptrs.ctx(args->data[0]);
+	auto  component_id =
+		ecsact_id_from_wasm_i32<ecsact_component_like_id>(args->data[1]);
+	auto component_data =
+		ptrs.get_component<const void>(component_id, args->data[2]);
+	auto indexed_fields = ptrs.get_indexed_fields(component_id, args->data[3]);
+
+	if(ptrs.out_of_bounds) {
+		return inst_env.out_of_bounds_trap( //
+			"ecsact_system_execution_context_update"
+		);
+	}
 
 	ecsact_system_execution_context_update(
 		ctx,
-		ecsact_id_from_wasm_i32<ecsact_component_like_id>(args->data[1]),
-		get_const_void_ptr(args->data[2], memory),
-		get_void_ptr(args->data[3], memory)
+		component_id,
+		component_data,
+		indexed_fields
 	);
 
 	return nullptr;
 }
 
 wasm_trap_t* wasm_ecsact_system_execution_context_has(
+	void*                 env,
 	const wasm_val_vec_t* args,
 	wasm_val_vec_t*       results
 ) {
 	debug_trace_method("ecsact_system_execution_context_has");
 
-	auto ctx = get_execution_context(args->data[0]);
-	auto memory = get_execution_context_memory(args->data[0]);
+	auto& inst_env = get_instance_env(env);
+	auto  ptrs = guest_ptr_args{inst_env};
+	auto  ctx = ptrs.ctx(args->data[0]);
+	auto  component_id =
+		ecsact_id_from_wasm_i32<ecsact_component_like_id>(args->data[1]);
+	auto indexed_fields = ptrs.get_indexed_fields(component_id, args->data[2]);
 
-	bool has_component = ecsact_system_execution_context_has(
-		ctx,
-		ecsact_id_from_wasm_i32<ecsact_component_like_id>(args->data[1]),
-		get_void_ptr(args->data[2], memory)
-	);
+	if(ptrs.out_of_bounds) {
+		return inst_env.out_of_bounds_trap("ecsact_system_execution_context_has");
+	}
+
+	bool has_component =
+		ecsact_system_execution_context_has(ctx, component_id, indexed_fields);
 
 	results->data[0].kind = WASM_I32;
 	results->data[0].of.i32 = has_component ? 1 : 0;
@@ -181,72 +368,355 @@ wasm_trap_t* wasm_ecsact_system_execution_context_has(
 	return nullptr;
 }
 
+wasm_trap_t* wasm_ecsact_system_execution_context_get_many(
+	void*                 env,
+	const wasm_val_vec_t* args,
+	wasm_val_vec_t*       results
+) {
+	debug_trace_method("ecsact_system_execution_context_get_many");
+
+	auto& inst_env = get_instance_env(env);
+	auto  ptrs = guest_ptr_args{inst_env};
+	auto  ctx = ptrs.ctx(args->data[0]);
+	auto  count = std::max(args->data[1].of.i32, 0);
+	auto  component_ids =
+		ptrs.get<const ecsact_component_like_id>(args->data[2], count);
+	auto out_components_data = ptrs.get<const std::int32_t>(args->data[3], count);
+	auto indexed_fields = ptrs.get<const std::int32_t>(args->data[4], count);
+
+	if(count > 0 && (!component_ids || !out_components_data)) {
+		ptrs.out_of_bounds = true;
+	}
+
+	if(ptrs.out_of_bounds ||
+		 !guest_ptr_array_in_bounds(
+			 ptrs,
+			 component_ptr_kind::data,
+			 component_ids,
+			 out_components_data,
+			 count
+		 ) ||
+		 !guest_ptr_array_in_bounds(
+			 ptrs,
+			 component_ptr_kind::indexed_fields,
+			 component_ids,
+			 indexed_fields,
+			 count
+		 )) {
+		return inst_env.out_of_bounds_trap( //
+			"ecsact_system_execution_context_get_many"
+		);
+	}
+
+	for(auto i = 0; count > i; ++i) {
+		ecsact_system_execution_context_get(
+			ctx,
+			component_ids[i],
+			ptrs.get_component(component_ids[i], out_components_data[i]),
+			indexed_fields
+				? ptrs.get_indexed_fields(component_ids[i], indexed_fields[i])
+				: nullptr
+		);
+	}
+
+	return nullptr;
+}
+
+wasm_trap_t* wasm_ecsact_system_execution_context_update_many(
+	void*                 env,
+	const wasm_val_vec_t* args,
+	wasm_val_vec_t*       results
+) {
+	debug_trace_method("ecsact_system_execution_context_update_many");
+
+	auto& inst_env = get_instance_env(env);
+	auto  ptrs = guest_ptr_args{inst_env};
+	auto  ctx = ptrs.ctx(args->data[0]);
+	auto  count = std::max(args->data[1].of.i32, 0);
+	auto  component_ids =
+		ptrs.get<const ecsact_component_like_id>(args->data[2], count);
+	auto components_data = ptrs.get<const std::int32_t>(args->data[3], count);
+	auto indexed_fields = ptrs.get<const std::int32_t>(args->data[4], count);
+
+	if(count > 0 && (!component_ids || !components_data)) {
+		ptrs.out_of_bounds = true;
+	}
+
+	if(ptrs.out_of_bounds ||
+		 !guest_ptr_array_in_bounds(
+			 ptrs,
+			 component_ptr_kind::data,
+			 component_ids,
+			 components_data,
+			 count
+		 ) ||
+		 !guest_ptr_array_in_bounds(
+			 ptrs,
+			 component_ptr_kind::indexed_fields,
+			 component_ids,
+			 indexed_fields,
+			 count
+		 )) {
+		return inst_env.out_of_bounds_trap( //
+			"ecsact_system_execution_context_update_many"
+		);
+	}
+
+	for(auto i = 0; count > i; ++i) {
+		ecsact_system_execution_context_update(
+			ctx,
+			component_ids[i],
+			ptrs.get_component<const void>(component_ids[i], components_data[i]),
+			indexed_fields
+				? ptrs.get_indexed_fields(component_ids[i], indexed_fields[i])
+				: nullptr
+		);
+	}
+
+	return nullptr;
+}
+
+wasm_trap_t* wasm_ecsact_system_execution_context_has_many(
+	void*                 env,
+	const wasm_val_vec_t* args,
+	wasm_val_vec_t*       results
+) {
+	debug_trace_method("ecsact_system_execution_context_has_many");
+
+	auto& inst_env = get_instance_env(env);
+	auto  ptrs = guest_ptr_args{inst_env};
+	auto  ctx = ptrs.ctx(args->data[0]);
+	auto  count = std::max(args->data[1].of.i32, 0);
+	auto  component_ids =
+		ptrs.get<const ecsact_component_like_id>(args->data[2], count);
+	auto indexed_fields = ptrs.get<const std::int32_t>(args->data[3], count);
+	// guest `bool` is a single byte
+	auto out_has = ptrs.get<std::uint8_t>(args->data[4], count);
+
+	if(count > 0 && (!component_ids || !out_has)) {
+		ptrs.out_of_bounds = true;
+	}
+
+	if(ptrs.out_of_bounds ||
+		 !guest_ptr_array_in_bounds(
+			 ptrs,
+			 component_ptr_kind::indexed_fields,
+			 component_ids,
+			 indexed_fields,
+			 count
+		 )) {
+		return inst_env.out_of_bounds_trap( //
+			"ecsact_system_execution_context_has_many"
+		);
+	}
+
+	for(auto i = 0; count > i; ++i) {
+		out_has[i] = ecsact_system_execution_context_has(
+			ctx,
+			component_ids[i],
+			indexed_fields
+				? ptrs.get_indexed_fields(component_ids[i], indexed_fields[i])
+				: nullptr
+		);
+	}
+
+	return nullptr;
+}
+
 wasm_trap_t* wasm_ecsact_system_execution_context_generate(
+	void*                 env,
 	const wasm_val_vec_t* args,
 	wasm_val_vec_t*       results
 ) {
 	debug_trace_method("ecsact_system_execution_context_generate");
 
-	auto ctx = get_execution_context(args->data[0]);
-	auto memory = get_execution_context_memory(args->data[0]);
-	auto components_count = args->data[1].of.i32;
+	auto& inst_env = get_instance_env(env);
+	auto  ptrs = guest_ptr_args{inst_env};
+	auto  ctx = ptrs.ctx(args->data[0]);
+	auto  components_count = args->data[1].of.i32;
 
-	std::vector<const void*> component_data_list;
-	component_data_list.resize(components_count);
+	if(components_count < 0) {
+		return inst_env.trap(
+			"ecsact_system_execution_context_generate: negative component count"
+		);
+	}
 
+	auto component_ids =
+		ptrs.get<ecsact_component_id>(args->data[2], components_count);
 	// each i32 element represents a pointer in WASM memory
-	auto component_data_list_wasm =
-		static_cast<int32_t*>(get_void_ptr(args->data[3], memory));
-	for(int i = 0; components_count > i; ++i) {
-		component_data_list[i] = get_const_void_ptr(
-			wasm_val_t{
-				.kind = WASM_I32,
-				.of{.i32 = component_data_list_wasm[i]},
-			},
-			memory
+	auto components_data_wasm =
+		ptrs.get<const int32_t>(args->data[3], components_count);
+
+	if(components_count > 0 && (!component_ids || !components_data_wasm)) {
+		ptrs.out_of_bounds = true;
+	}
+
+	if(ptrs.out_of_bounds ||
+		 !guest_ptr_array_in_bounds(
+			 ptrs,
+			 component_ptr_kind::data,
+			 component_ids,
+			 components_data_wasm,
+			 components_count
+		 )) {
+		return inst_env.out_of_bounds_trap( //
+			"ecsact_system_execution_context_generate"
 		);
 	}
 
 	ecsact_system_execution_context_generate(
 		ctx,
 		components_count,
-		static_cast<ecsact_component_id*>(get_void_ptr(args->data[2], memory)),
-		component_data_list.data()
+		component_ids,
+		translate_components_data(
+			inst_env,
+			ptrs,
+			component_ids,
+			components_data_wasm,
+			components_count
+		)
 	);
 	return nullptr;
 }
 
+wasm_trap_t* wasm_ecsact_system_execution_context_generate_many(
+	void*                 env,
+	const wasm_val_vec_t* args,
+	wasm_val_vec_t*       results
+) {
+	debug_trace_method("ecsact_system_execution_context_generate_many");
+
+	auto& inst_env = get_instance_env(env);
+	auto  ptrs = guest_ptr_args{inst_env};
+	auto  ctx = ptrs.ctx(args->data[0]);
+	auto  entities_count = args->data[1].of.i32;
+
+	if(entities_count < 0) {
+		return inst_env.trap(
+			"ecsact_system_execution_context_generate_many: negative entity count"
+		);
+	}
+
+	auto components_counts =
+		ptrs.get<const int32_t>(args->data[2], entities_count);
+	if(ptrs.out_of_bounds || (entities_count > 0 && !components_counts)) {
+		return inst_env.out_of_bounds_trap( //
+			"ecsact_system_execution_context_generate_many"
+		);
+	}
+
+	auto total_components_count = std::int64_t{};
+	for(auto i = 0; entities_count > i; ++i) {
+		if(components_counts[i] < 0) {
+			return inst_env.trap(
+				"ecsact_system_execution_context_generate_many: negative component "
+				"count"
+			);
+		}
+		total_components_count += components_counts[i];
+	}
+
+	if(total_components_count > std::numeric_limits<std::int32_t>::max()) {
+		return inst_env.out_of_bounds_trap( //
+			"ecsact_system_execution_context_generate_many"
+		);
+	}
+
+	auto total_count = static_cast<std::int32_t>(total_components_count);
+	auto component_ids =
+		ptrs.get<ecsact_component_id>(args->data[3], total_count);
+	// each i32 element represents a pointer in WASM memory
+	auto components_data_wasm =
+		ptrs.get<const int32_t>(args->data[4], total_count);
+
+	if(total_count > 0 && (!component_ids || !components_data_wasm)) {
+		ptrs.out_of_bounds = true;
+	}
+
+	if(ptrs.out_of_bounds ||
+		 !guest_ptr_array_in_bounds(
+			 ptrs,
+			 component_ptr_kind::data,
+			 component_ids,
+			 components_data_wasm,
+			 total_count
+		 )) {
+		return inst_env.out_of_bounds_trap( //
+			"ecsact_system_execution_context_generate_many"
+		);
+	}
+
+	auto offset = 0;
+	for(auto i = 0; entities_count > i; ++i) {
+		auto components_count = components_counts[i];
+		ecsact_system_execution_context_generate(
+			ctx,
+			components_count,
+			component_ids + offset,
+			translate_components_data(
+				inst_env,
+				ptrs,
+				component_ids + offset,
+				components_data_wasm + offset,
+				components_count
+			)
+		);
+		offset += components_count;
+	}
+
+	return nullptr;
+}
+
 wasm_trap_t* wasm_ecsact_system_execution_context_parent(
+	void*                 env,
 	const wasm_val_vec_t* args,
 	wasm_val_vec_t*       results
 ) {
 	debug_trace_method("ecsact_system_execution_context_parent");
 
-	auto ctx = get_execution_context(args->data[0]);
-	auto mem = get_execution_context_memory(args->data[0]);
-	auto system_id = ecsact_system_execution_context_id(ctx);
+	auto& inst_env = get_instance_env(env);
+	auto  ptrs = guest_ptr_args{inst_env};
+	auto  ctx = ptrs.ctx(args->data[0]);
+
+	if(ptrs.out_of_bounds) {
+		return inst_env.out_of_bounds_trap( //
+			"ecsact_system_execution_context_parent"
+		);
+	}
 
-	call_mem_alloc(mem);
 	auto parent = ecsact_system_execution_context_parent(ctx);
+	auto parent_handle = inst_env.ctx_handles.get(parent);
+	if(parent_handle == call_mem_invalid_offset) {
+		return inst_env.call_mem_exhausted_trap( //
+			"ecsact_system_execution_context_parent"
+		);
+	}
 
 	results->data[0].kind = WASM_I32;
-	results->data[0].of.i32 = ecsact::wasm::detail::call_mem_alloc(
-		const_cast<ecsact_system_execution_context*>(parent)
-	);
+	results->data[0].of.i32 = parent_handle;
 
 	return nullptr;
 }
 
 wasm_trap_t* wasm_ecsact_system_execution_context_same(
+	void*                 env,
 	const wasm_val_vec_t* args,
 	wasm_val_vec_t*       results
 ) {
 	debug_trace_method("ecsact_system_execution_context_same");
 
-	bool same = ecsact_system_execution_context_same(
-		get_execution_context(args->data[0]),
-		get_execution_context(args->data[1])
-	);
+	auto& inst_env = get_instance_env(env);
+	auto  ptrs = guest_ptr_args{inst_env};
+	auto  a = ptrs.ctx(args->data[0]);
+	auto  b = ptrs.ctx(args->data[1]);
+
+	if(ptrs.out_of_bounds) {
+		return inst_env.out_of_bounds_trap( //
+			"ecsact_system_execution_context_same"
+		);
+	}
+
+	bool same = ecsact_system_execution_context_same(a, b);
 
 	results->data[0].kind = WASM_I32;
 	results->data[0].of.i32 = same ? 1 : 0;
@@ -255,36 +725,60 @@ wasm_trap_t* wasm_ecsact_system_execution_context_same(
 }
 
 wasm_trap_t* wasm_ecsact_system_execution_context_other(
+	void*                 env,
 	const wasm_val_vec_t* args,
 	wasm_val_vec_t*       results
 ) {
 	debug_trace_method("ecsact_system_execution_context_other");
 
-	auto ctx = get_execution_context(args->data[0]);
-	auto mem = get_execution_context_memory(args->data[0]);
-	auto system_id = ecsact_system_execution_context_id(ctx);
+	auto& inst_env = get_instance_env(env);
+	auto  ptrs = guest_ptr_args{inst_env};
+	auto  ctx = ptrs.ctx(args->data[0]);
+	auto  assoc_id =
+		ecsact_id_from_wasm_i32<ecsact_system_assoc_id>(args->data[1]);
 
-	auto other = ecsact_system_execution_context_other(
-		ctx,
-		ecsact_id_from_wasm_i32<ecsact_system_assoc_id>(args->data[1])
-	);
+	if(ptrs.out_of_bounds) {
+		return inst_env.out_of_bounds_trap( //
+			"ecsact_system_execution_context_other"
+		);
+	}
+
+	auto other_handle = inst_env.ctx_handles.find_other(ctx, assoc_id);
+	if(!other_handle) {
+		auto other = ecsact_system_execution_context_other(ctx, assoc_id);
+		other_handle = inst_env.ctx_handles.get(other);
+		if(other_handle == call_mem_invalid_offset) {
+			return inst_env.call_mem_exhausted_trap( //
+				"ecsact_system_execution_context_other"
+			);
+		}
+		inst_env.ctx_handles.cache_other(ctx, assoc_id, *other_handle);
+	}
 
-	call_mem_alloc(mem);
 	results->data[0].kind = WASM_I32;
-	results->data[0].of.i32 = call_mem_alloc(other);
+	results->data[0].of.i32 = *other_handle;
 
 	return nullptr;
 }
 
 wasm_trap_t* wasm_ecsact_system_execution_context_entity(
+	void*                 env,
 	const wasm_val_vec_t* args,
 	wasm_val_vec_t*       results
 ) {
 	debug_trace_method("ecsact_system_execution_context_entity");
 
-	auto entity = ecsact_system_execution_context_entity( //
-		get_execution_context(args->data[0])
-	);
+	auto& inst_env = get_instance_env(env);
+	auto  ptrs = guest_ptr_args{inst_env};
+	auto  ctx = ptrs.ctx(args->data[0]);
+
+	if(ptrs.out_of_bounds) {
+		return inst_env.out_of_bounds_trap( //
+			"ecsact_system_execution_context_entity"
+		);
+	}
+
+	auto entity = ecsact_system_execution_context_entity(ctx);
 	results->data[0].kind = WASM_I32;
 	results->data[0].of.i32 = static_cast<int32_t>(entity);
 
@@ -292,22 +786,246 @@ wasm_trap_t* wasm_ecsact_system_execution_context_entity(
 }
 
 wasm_trap_t* wasm_ecsact_system_execution_context_stream_toggle(
+	void*                 env,
 	const wasm_val_vec_t* args,
 	wasm_val_vec_t*       results
 ) {
 	debug_trace_method("ecsact_system_execution_context_stream_toggle");
 
-	auto ctx = get_execution_context(args->data[0]);
-	auto memory = get_execution_context_memory(args->data[0]);
+	auto& inst_env = get_instance_env(env);
+	auto  ptrs = guest_ptr_args{inst_env};
+	auto  ctx = ptrs.ctx(args->data[0]);
+
+	auto  component_id =
+		ecsact_id_from_wasm_i32<ecsact_component_id>(args->data[1]);
 
 	assert(args->data[2].kind == WASM_I32);
+	auto indexed_field_values =
+		ptrs.get_indexed_fields<const void>(component_id, args->data[3]);
+
+	if(ptrs.out_of_bounds) {
+		return inst_env.out_of_bounds_trap( //
+			"ecsact_system_execution_context_stream_toggle"
+		);
+	}
 
 	ecsact_system_execution_context_stream_toggle(
 		ctx,
-		ecsact_id_from_wasm_i32<ecsact_component_id>(args->data[1]),
+		component_id,
 		static_cast<bool>(args->data[2].of.i32),
-		get_const_void_ptr(args->data[2], memory) // indexed field values
+		indexed_field_values
 	);
 
 	return nullptr;
 }
+
+wasm_trap_t* wasm_ecsact_si_wasm_register_readonly_frame(
+	void*                 env,
+	const wasm_val_vec_t* args,
+	wasm_val_vec_t*       results
+) {
+	debug_trace_method("ecsact_si_wasm_register_readonly_frame");
+
+	auto& inst_env = get_instance_env(env);
+	auto  ptrs = guest_ptr_args{inst_env};
+	auto  system_id =
+		ecsact_id_from_wasm_i32<ecsact_system_like_id>(args->data[0]);
+	auto frame_ptr = args->data[1].of.i32;
+	auto count = std::max(args->data[2].of.i32, 0);
+	auto component_ids =
+		ptrs.get<const ecsact_component_like_id>(args->data[3], count);
+	auto component_offsets = ptrs.get<const std::int32_t>(args->data[4], count);
+	auto component_sizes = ptrs.get<const std::int32_t>(args->data[5], count);
+
+	if(count > 0 && (!component_ids || !component_offsets || !component_sizes)) {
+		ptrs.out_of_bounds = true;
+	}
+
+	if(ptrs.out_of_bounds) {
+		return inst_env.out_of_bounds_trap( //
+			"ecsact_si_wasm_register_readonly_frame"
+		);
+	}
+
+	auto frame = readonly_frame{};
+	frame.guest_ptr = frame_ptr;
+	frame.size = static_cast<std::size_t>(readonly_frame::has_offset + count);
+	frame.component_ids.assign(component_ids, component_ids + count);
+	frame.component_offsets.assign(component_offsets, component_offsets + count);
+
+	for(auto i = 0; count > i; ++i) {
+		auto capability = system_capability(system_id, component_ids[i]);
+		if(!capability ||
+			 (*capability & ECSACT_SYS_CAP_READONLY) != ECSACT_SYS_CAP_READONLY) {
+			return inst_env.trap(
+				"ecsact_si_wasm_register_readonly_frame: component is not readable by "
+				"the system"
+			);
+		}
+
+		// component data may not overlap the entity or has flags
+		if(component_offsets[i] < readonly_frame::has_offset + count) {
+			return inst_env.trap(
+				"ecsact_si_wasm_register_readonly_frame: invalid component offset"
+			);
+		}
+
+		// the runtime writes the whole component into the frame
+		auto component_size = inst_env.component_size(component_ids[i]);
+		if(!component_size || component_sizes[i] < 0 ||
+			 static_cast<std::size_t>(component_sizes[i]) < *component_size) {
+			return inst_env.trap(
+				"ecsact_si_wasm_register_readonly_frame: invalid component size"
+			);
+		}
+
+		frame.size = std::max(
+			frame.size,
+			static_cast<std::size_t>(component_offsets[i]) + *component_size
+		);
+	}
+
+	if(frame_ptr == 0 || !ptrs.get(frame_ptr, frame.size)) {
+		return inst_env.out_of_bounds_trap( //
+			"ecsact_si_wasm_register_readonly_frame"
+		);
+	}
+
+	inst_env.readonly_frames.insert_or_assign(system_id, std::move(frame));
+
+	return nullptr;
+}
+
+wasm_trap_t* wasm_ecsact_si_wasm_register_action_cache(
+	void*                 env,
+	const wasm_val_vec_t* args,
+	wasm_val_vec_t*       results
+) {
+	debug_trace_method("ecsact_si_wasm_register_action_cache");
+
+	auto& inst_env = get_instance_env(env);
+	auto  ptrs = guest_ptr_args{inst_env};
+	auto  action_id =
+		ecsact_id_from_wasm_i32<ecsact_system_like_id>(args->data[0]);
+	auto action_buffer_ptr = args->data[1].of.i32;
+	auto action_buffer_size = args->data[2].of.i32;
+
+	if(action_buffer_size <= 0) {
+		return inst_env.trap(
+			"ecsact_si_wasm_register_action_cache: invalid action buffer size"
+		);
+	}
+
+	auto cache = action_cache{
+		.guest_ptr = action_buffer_ptr,
+		.size = static_cast<std::size_t>(action_buffer_size),
+	};
+
+	if(action_buffer_ptr == 0 || !ptrs.get(action_buffer_ptr, cache.size)) {
+		return inst_env.out_of_bounds_trap( //
+			"ecsact_si_wasm_register_action_cache"
+		);
+	}
+
+	inst_env.action_caches.insert_or_assign(action_id, cache);
+
+	return nullptr;
+}
+
+wasm_trap_t* wasm_ecsact_si_wasm_register_presence_mask(
+	void*                 env,
+	const wasm_val_vec_t* args,
+	wasm_val_vec_t*       results
+) {
+	debug_trace_method("ecsact_si_wasm_register_presence_mask");
+
+	auto& inst_env = get_instance_env(env);
+	auto  ptrs = guest_ptr_args{inst_env};
+	auto  system_id =
+		ecsact_id_from_wasm_i32<ecsact_system_like_id>(args->data[0]);
+	auto mask_ptr = args->data[1].of.i32;
+	auto count = std::max(args->data[2].of.i32, 0);
+	auto component_ids =
+		ptrs.get<const ecsact_component_like_id>(args->data[3], count);
+
+	if(count > static_cast<int32_t>(presence_mask::max_components)) {
+		return inst_env.trap(
+			"ecsact_si_wasm_register_presence_mask: too many components"
+		);
+	}
+
+	if(count > 0 && !component_ids) {
+		ptrs.out_of_bounds = true;
+	}
+
+	if(mask_ptr == 0 || !ptrs.get(mask_ptr, sizeof(uint64_t))) {
+		ptrs.out_of_bounds = true;
+	}
+
+	if(ptrs.out_of_bounds) {
+		return inst_env.out_of_bounds_trap( //
+			"ecsact_si_wasm_register_presence_mask"
+		);
+	}
+
+	// presence is only meaningful for components in the system's query
+	for(auto i = 0; count > i; ++i) {
+		if(!system_capability(system_id, component_ids[i])) {
+			return inst_env.trap(
+				"ecsact_si_wasm_register_presence_mask: component is not a capability "
+				"of the system"
+			);
+		}
+	}
+
+	auto mask = presence_mask{};
+	mask.guest_ptr = mask_ptr;
+	mask.component_ids.assign(component_ids, component_ids + count);
+
+	inst_env.presence_masks.insert_or_assign(system_id, std::move(mask));
+
+	return nullptr;
+}
+
+wasm_trap_t* wasm_ecsact_si_wasm_call_mem_push_frame(
+	void*                 env,
+	const wasm_val_vec_t* args,
+	wasm_val_vec_t*       results
+) {
+	debug_trace_method("ecsact_si_wasm_call_mem_push_frame");
+
+	auto& inst_env = get_instance_env(env);
+	inst_env.guest_frames.push_back(call_mem_push_frame());
+
+	// The guest only ever sees the frame depth
+	results->data[0].kind = WASM_I32;
+	results->data[0].of.i32 = static_cast<int32_t>(inst_env.guest_frames.size());
+
+	return nullptr;
+}
+
+wasm_trap_t* wasm_ecsact_si_wasm_call_mem_pop_frame(
+	void*                 env,
+	const wasm_val_vec_t* args,
+	wasm_val_vec_t*       results
+) {
+	debug_trace_method("ecsact_si_wasm_call_mem_pop_frame");
+
+	auto& inst_env = get_instance_env(env);
+	auto  frame_depth = args->data[0].of.i32;
+
+	// Frames must be popped in reverse push order
+	if(frame_depth <= static_cast<int32_t>(inst_env.guest_frames_base) ||
+		 frame_depth != static_cast<int32_t>(inst_env.guest_frames.size())) {
+		return inst_env.trap(
+			"ecsact_si_wasm_call_mem_pop_frame: frame is not the innermost frame"
+		);
+	}
+
+	auto frame = inst_env.guest_frames.back();
+	inst_env.guest_frames.pop_back();
+	inst_env.ctx_handles.truncate(frame.offset);
+	call_mem_pop_frame(frame);
+
+	return nullptr;
+}
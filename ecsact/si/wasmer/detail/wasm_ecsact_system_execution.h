@@ -11,61 +11,127 @@
 #include "ecsact/runtime/common.h"
 
 wasm_trap_t* wasm_ecsact_system_execution_context_action(
+	void*                 env,
 	const wasm_val_vec_t* args,
 	wasm_val_vec_t*       results
 );
 
 wasm_trap_t* wasm_ecsact_system_execution_context_add(
+	void*                 env,
 	const wasm_val_vec_t* args,
 	wasm_val_vec_t*       results
 );
 
 wasm_trap_t* wasm_ecsact_system_execution_context_remove(
+	void*                 env,
 	const wasm_val_vec_t* args,
 	wasm_val_vec_t*       results
 );
 
 wasm_trap_t* wasm_ecsact_system_execution_context_get(
+	void*                 env,
 	const wasm_val_vec_t* args,
 	wasm_val_vec_t*       results
 );
 
 wasm_trap_t* wasm_ecsact_system_execution_context_update(
+	void*                 env,
 	const wasm_val_vec_t* args,
 	wasm_val_vec_t*       results
 );
 
 wasm_trap_t* wasm_ecsact_system_execution_context_has(
+	void*                 env,
+	const wasm_val_vec_t* args,
+	wasm_val_vec_t*       results
+);
+
+wasm_trap_t* wasm_ecsact_system_execution_context_get_many(
+	void*                 env,
+	const wasm_val_vec_t* args,
+	wasm_val_vec_t*       results
+);
+
+wasm_trap_t* wasm_ecsact_system_execution_context_update_many(
+	void*                 env,
+	const wasm_val_vec_t* args,
+	wasm_val_vec_t*       results
+);
+
+wasm_trap_t* wasm_ecsact_system_execution_context_has_many(
+	void*                 env,
 	const wasm_val_vec_t* args,
 	wasm_val_vec_t*       results
 );
 
 wasm_trap_t* wasm_ecsact_system_execution_context_generate(
+	void*                 env,
+	const wasm_val_vec_t* args,
+	wasm_val_vec_t*       results
+);
+
+wasm_trap_t* wasm_ecsact_system_execution_context_generate_many(
+	void*                 env,
 	const wasm_val_vec_t* args,
 	wasm_val_vec_t*       results
 );
 
 wasm_trap_t* wasm_ecsact_system_execution_context_parent(
+	void*                 env,
 	const wasm_val_vec_t* args,
 	wasm_val_vec_t*       results
 );
 
 wasm_trap_t* wasm_ecsact_system_execution_context_same(
+	void*                 env,
 	const wasm_val_vec_t* args,
 	wasm_val_vec_t*       results
 );
 
 wasm_trap_t* wasm_ecsact_system_execution_context_other(
+	void*                 env,
 	const wasm_val_vec_t* args,
 	wasm_val_vec_t*       results
 );
 
 wasm_trap_t* wasm_ecsact_system_execution_context_entity(
+	void*                 env,
 	const wasm_val_vec_t* args,
 	wasm_val_vec_t*       results
 );
 
 wasm_trap_t* wasm_ecsact_system_execution_context_stream_toggle(
+	void*                 env,
+	const wasm_val_vec_t* args,
+	wasm_val_vec_t*       results
+);
+
+wasm_trap_t* wasm_ecsact_si_wasm_register_readonly_frame(
+	void*                 env,
+	const wasm_val_vec_t* args,
+	wasm_val_vec_t*       results
+);
+
+wasm_trap_t* wasm_ecsact_si_wasm_register_action_cache(
+	void*                 env,
+	const wasm_val_vec_t* args,
+	wasm_val_vec_t*       results
+);
+
+wasm_trap_t* wasm_ecsact_si_wasm_register_presence_mask(
+	void*                 env,
+	const wasm_val_vec_t* args,
+	wasm_val_vec_t*       results
+);
+
+wasm_trap_t* wasm_ecsact_si_wasm_call_mem_push_frame(
+	void*                 env,
+	const wasm_val_vec_t* args,
+	wasm_val_vec_t*       results
+);
+
+wasm_trap_t* wasm_ecsact_si_wasm_call_mem_pop_frame(
+	void*                 env,
 	const wasm_val_vec_t* args,
 	wasm_val_vec_t*       results
 );
@@ -0,0 +1,32 @@
+#ifndef ECSACT_SI_WASMER_ENVIRONMENT_H
+#define ECSACT_SI_WASMER_ENVIRONMENT_H
+
+#include <stdint.h>
+#include "ecsact/si/wasm.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Sets the environment variables guests see through `getenv`. Each of
+ * @p vars is a `KEY=VALUE` string and is copied. The block is laid out once
+ * and shared by every instance.
+ *
+ * An instance reads its environment once, the first time the guest asks for
+ * it (usually during `_initialize`), so call this before
+ * `ecsact_si_wasm_load`. Passing no variables clears the environment.
+ *
+ * @returns 0 on success or -1 if an entry is not a `KEY=VALUE` string, in
+ *          which case the environment is left unchanged
+ */
+ECSACT_SI_WASM_API int32_t ecsact_si_wasmer_set_environment(
+	const char* const* vars,
+	int32_t            vars_count
+);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ECSACT_SI_WASMER_ENVIRONMENT_H
@@ -0,0 +1,97 @@
+#ifndef ECSACT_SI_WASMER_FS_H
+#define ECSACT_SI_WASMER_FS_H
+
+#include <stdint.h>
+#include "ecsact/si/wasm.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Allows guests to read every file below @p real_dir_path through a WASI
+ * preopened directory named @p virtual_dir_path (e.g. `"assets"` lets guests
+ * `fopen("assets/a.bin", "rb")`.) Guests can open files and list directories
+ * but never write, and paths can not leave the directory.
+ *
+ * Registering a @p virtual_dir_path again replaces the previous directory.
+ * At most 8 directories can be registered. Guests only see directories
+ * registered before they are loaded.
+ *
+ * @param build_index non-zero to read the directory tree once now so opening
+ *        files and listing directories never touch the disk. Changes made to
+ *        the directory afterwards are not seen by guests.
+ *
+ * @returns the preopen file descriptor or -1 if @p real_dir_path is not a
+ *          directory or too many directories are registered
+ */
+ECSACT_SI_WASM_API int32_t ecsact_si_wasmer_allow_dir_read_access(
+	const char* real_dir_path,
+	const char* virtual_dir_path,
+	int32_t     build_index
+);
+
+/**
+ * Allows guests to read a copy of @p data as @p virtual_file_path. The copy is
+ * made once and every instance reads from it, so reads never touch the disk.
+ * @p data may be freed after this returns.
+ *
+ * @returns the file descriptor guests use for the file or -1 if @p size is
+ *          negative
+ */
+ECSACT_SI_WASM_API int32_t ecsact_si_wasmer_allow_file_read_buffer(
+	const char* virtual_file_path,
+	const void* data,
+	int64_t     size
+);
+
+/**
+ * Like `ecsact_si_wasm_allow_file_read_access` but the whole file is read
+ * into memory now, once, and shared by every instance. Later changes to the
+ * file are not seen by guests.
+ *
+ * @returns the file descriptor guests use for the file or -1 if
+ *          @p real_file_path is not a regular file or could not be read
+ */
+ECSACT_SI_WASM_API int32_t ecsact_si_wasmer_preload_file(
+	const char* real_file_path,
+	const char* virtual_file_path
+);
+
+/**
+ * Creates (or truncates) @p real_file_path and allows guests to write to it
+ * as @p virtual_file_path. Guest writes only append to a buffer of the
+ * writing thread and never wait on the disk. A background thread writes the
+ * buffers out periodically. Writes from one thread keep their order, writes
+ * from different threads may land in any order. Writes that don't fit in a
+ * full buffer are dropped (see `ecsact_si_wasmer_dropped_written_bytes_count`.)
+ * Allowing a file that is already allowed for writing does not truncate it
+ * again.
+ *
+ * @returns the file descriptor guests use for the file or -1 if
+ *          @p real_file_path could not be opened for writing
+ */
+ECSACT_SI_WASM_API int32_t ecsact_si_wasmer_allow_file_write_access(
+	const char* real_file_path,
+	const char* virtual_file_path
+);
+
+/**
+ * Writes everything guests wrote to files allowed with
+ * `ecsact_si_wasmer_allow_file_write_access` so far to disk before
+ * returning.
+ */
+ECSACT_SI_WASM_API void ecsact_si_wasmer_flush_written_files(void);
+
+/**
+ * Total number of bytes guests wrote to files allowed with
+ * `ecsact_si_wasmer_allow_file_write_access` that were dropped because the
+ * writing thread's buffer was full.
+ */
+ECSACT_SI_WASM_API int64_t ecsact_si_wasmer_dropped_written_bytes_count(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ECSACT_SI_WASMER_FS_H
@@ -0,0 +1,420 @@
+#pragma once
+
+/**
+ * @file
+ * Guest (wasm) side helpers for host imports that ecsact_si_wasmer provides in
+ * addition to the standard ecsact system execution context functions. Only
+ * include this in code compiled to wasm.
+ */
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+#include "ecsact/runtime/common.h"
+
+/**
+ * Same as calling `ecsact_system_execution_context_get` for each of the
+ * @p components_count components, but in a single host call.
+ * @param indexed_fields may be `nullptr` if none of the components have
+ *        indexed fields
+ */
+ECSACT_IMPORT("env", "ecsact_system_execution_context_get_many")
+void ecsact_system_execution_context_get_many(
+	struct ecsact_system_execution_context* context,
+	int32_t                                 components_count,
+	const ecsact_component_like_id*         component_ids,
+	void* const*                            out_components_data,
+	const void* const*                      indexed_fields
+);
+
+/**
+ * Same as calling `ecsact_system_execution_context_update` for each of the
+ * @p components_count components, but in a single host call.
+ * @param indexed_fields may be `nullptr` if none of the components have
+ *        indexed fields
+ */
+ECSACT_IMPORT("env", "ecsact_system_execution_context_update_many")
+void ecsact_system_execution_context_update_many(
+	struct ecsact_system_execution_context* context,
+	int32_t                                 components_count,
+	const ecsact_component_like_id*         component_ids,
+	const void* const*                      components_data,
+	const void* const*                      indexed_fields
+);
+
+/**
+ * Same as calling `ecsact_system_execution_context_has` for each of the
+ * @p components_count components, but in a single host call.
+ * @param indexed_fields may be `nullptr` if none of the components have
+ *        indexed fields
+ */
+ECSACT_IMPORT("env", "ecsact_system_execution_context_has_many")
+void ecsact_system_execution_context_has_many(
+	struct ecsact_system_execution_context* context,
+	int32_t                                 components_count,
+	const ecsact_component_like_id*         component_ids,
+	const void* const*                      indexed_fields,
+	bool*                                   out_has
+);
+
+/**
+ * Same as calling `ecsact_system_execution_context_generate` once per entity,
+ * but in a single host call. @p component_ids and @p components_data are the
+ * concatenation of every entity's components, where entity N has
+ * `components_counts[N]` components.
+ */
+ECSACT_IMPORT("env", "ecsact_system_execution_context_generate_many")
+void ecsact_system_execution_context_generate_many(
+	struct ecsact_system_execution_context* context,
+	int32_t                                 entities_count,
+	const int32_t*                          components_counts,
+	const ecsact_component_id*              component_ids,
+	const void* const*                      components_data
+);
+
+/**
+ * Registers a guest memory frame that the host fills with the entity and the
+ * listed components before every call to @p system_id's impl.
+ *
+ * Frame layout: i32 entity at offset 0, followed by @p components_count
+ * `bool` has flags at offset 4. Component N is written at
+ * `component_offsets[N]` if the entity has it. Components with indexed fields
+ * are not supported.
+ *
+ * Traps if @p system_id may not read one of the components or one of
+ * @p component_sizes is smaller than the component.
+ */
+ECSACT_IMPORT("env", "ecsact_si_wasm_register_readonly_frame")
+void ecsact_si_wasm_register_readonly_frame(
+	ecsact_system_like_id           system_id,
+	void*                           frame,
+	int32_t                         components_count,
+	const ecsact_component_like_id* component_ids,
+	const int32_t*                  component_offsets,
+	const int32_t*                  component_sizes
+);
+
+ECSACT_IMPORT("env", "ecsact_si_wasm_register_action_cache")
+void ecsact_si_wasm_register_action_cache(
+	ecsact_action_id action_id,
+	void*            action_buffer,
+	int32_t          action_buffer_size
+);
+
+/**
+ * Registers a guest `u64` that the host sets before every call to
+ * @p system_id's impl. Bit N is set when the entity has `component_ids[N]`.
+ *
+ * Traps if @p system_id declares no capability for one of the components or
+ * more than 64 components are listed.
+ */
+ECSACT_IMPORT("env", "ecsact_si_wasm_register_presence_mask")
+void ecsact_si_wasm_register_presence_mask(
+	ecsact_system_like_id           system_id,
+	uint64_t*                       mask,
+	int32_t                         components_count,
+	const ecsact_component_like_id* component_ids
+);
+
+ECSACT_IMPORT("env", "ecsact_si_wasm_call_mem_push_frame")
+int32_t ecsact_si_wasm_call_mem_push_frame();
+
+ECSACT_IMPORT("env", "ecsact_si_wasm_call_mem_pop_frame")
+void ecsact_si_wasm_call_mem_pop_frame(int32_t frame);
+
+namespace ecsact::si::wasm::guest {
+
+namespace detail {
+template<typename T, typename... C>
+constexpr auto type_index = [] {
+	constexpr bool matches[] = {std::is_same_v<T, C>...};
+	for(auto i = std::size_t{}; sizeof...(C) > i; ++i) {
+		if(matches[i]) {
+			return i;
+		}
+	}
+	return sizeof...(C);
+}();
+} // namespace detail
+
+/**
+ * Readable components of a system's entity, filled in by the host before the
+ * system impl is called. Reading from the frame replaces host calls to `get`,
+ * `has` and `entity`. Writes must still go through `update`.
+ *
+ * Each wasm instance has its own memory, so a frame should be a static that
+ * is registered once with `register_readonly_frame` during initialization.
+ */
+template<typename... C>
+struct readonly_frame {
+	ecsact_entity_id               entity;
+	std::array<bool, sizeof...(C)> has_flags;
+	std::tuple<C...>               components;
+
+	template<typename T>
+	auto get() const -> const T& {
+		return std::get<T>(components);
+	}
+
+	template<typename T>
+	auto has() const -> bool {
+		static_assert(detail::type_index<T, C...> < sizeof...(C));
+		return has_flags[detail::type_index<T, C...>];
+	}
+};
+
+template<typename... C>
+auto register_readonly_frame(
+	ecsact_system_like_id system_id,
+	readonly_frame<C...>& frame
+) -> void {
+	const auto frame_base = reinterpret_cast<const std::byte*>(&frame);
+	const auto component_ids = std::array{
+		ecsact_id_cast<ecsact_component_like_id>(C::id)...,
+	};
+	const auto component_offsets = std::apply(
+		[&](const auto&... component) {
+			return std::array<int32_t, sizeof...(C)>{static_cast<int32_t>(
+				reinterpret_cast<const std::byte*>(&component) - frame_base
+			)...};
+		},
+		frame.components
+	);
+	const auto component_sizes = std::array<int32_t, sizeof...(C)>{
+		static_cast<int32_t>(sizeof(C))...,
+	};
+
+	ecsact_si_wasm_register_readonly_frame(
+		system_id,
+		&frame,
+		static_cast<int32_t>(sizeof...(C)),
+		component_ids.data(),
+		component_offsets.data(),
+		component_sizes.data()
+	);
+}
+
+/**
+ * Host call memory frame for the lifetime of the scope. Context handles
+ * returned by `parent` and `other` inside the scope are reclaimed when it
+ * ends, which keeps long loops over associations from exhausting call memory.
+ * Handles obtained inside the scope must not be used after it.
+ */
+class call_mem_scope {
+public:
+	call_mem_scope() : _frame(ecsact_si_wasm_call_mem_push_frame()) {
+	}
+
+	call_mem_scope(const call_mem_scope&) = delete;
+	auto operator=(const call_mem_scope&) -> call_mem_scope& = delete;
+
+	~call_mem_scope() {
+		ecsact_si_wasm_call_mem_pop_frame(_frame);
+	}
+
+private:
+	int32_t _frame;
+};
+
+/**
+ * Bitmask of which of @p C the executing entity has. Set by the host before
+ * every system impl call once registered with `register_presence_mask`.
+ */
+template<typename... C>
+struct presence_mask {
+	static_assert(sizeof...(C) <= 64, "presence_mask supports 64 components");
+
+	uint64_t bits;
+
+	template<typename T>
+	auto has() const -> bool {
+		static_assert(detail::type_index<T, C...> < sizeof...(C));
+		return (bits >> detail::type_index<T, C...>) & 1;
+	}
+};
+
+/**
+ * Registers @p mask for @p system_id. Typically @p C are the system's optional
+ * and checked components.
+ */
+template<typename... C>
+auto register_presence_mask(
+	ecsact_system_like_id system_id,
+	presence_mask<C...>&  mask
+) -> void {
+	const auto component_ids = std::array{
+		ecsact_id_cast<ecsact_component_like_id>(C::id)...,
+	};
+
+	ecsact_si_wasm_register_presence_mask(
+		system_id,
+		&mask.bits,
+		static_cast<int32_t>(sizeof...(C)),
+		component_ids.data()
+	);
+}
+
+/**
+ * Registers @p action as the buffer the host copies action @p Action into
+ * before every call of the action's system impl. Read @p action directly
+ * instead of calling `ecsact_system_execution_context_action`.
+ */
+template<typename Action>
+auto register_action_cache(Action& action) -> void {
+	ecsact_si_wasm_register_action_cache(
+		Action::id,
+		&action,
+		static_cast<int32_t>(sizeof(Action))
+	);
+}
+
+/**
+ * Gets all of @p C in a single host call.
+ *
+ * USAGE: auto [a, b, c] = ecsact::si::wasm::guest::get<A, B, C>(ctx);
+ */
+template<typename... C>
+auto get(ecsact_system_execution_context* ctx) -> std::tuple<C...> {
+	auto       components = std::tuple<C...>{};
+	const auto component_ids = std::array{
+		ecsact_id_cast<ecsact_component_like_id>(C::id)...,
+	};
+	auto out_components_data = std::apply(
+		[](auto&... component) {
+			return std::array<void*, sizeof...(C)>{&component...};
+		},
+		components
+	);
+
+	ecsact_system_execution_context_get_many(
+		ctx,
+		static_cast<int32_t>(sizeof...(C)),
+		component_ids.data(),
+		out_components_data.data(),
+		nullptr
+	);
+
+	return components;
+}
+
+/**
+ * Updates all of @p components in a single host call.
+ */
+template<typename... C>
+auto update(ecsact_system_execution_context* ctx, const C&... components)
+	-> void {
+	const auto component_ids = std::array{
+		ecsact_id_cast<ecsact_component_like_id>(C::id)...,
+	};
+	const auto components_data = std::array<const void*, sizeof...(C)>{
+		&components...,
+	};
+
+	ecsact_system_execution_context_update_many(
+		ctx,
+		static_cast<int32_t>(sizeof...(C)),
+		component_ids.data(),
+		components_data.data(),
+		nullptr
+	);
+}
+
+/**
+ * Checks for all of @p C in a single host call.
+ * @returns array in the same order as @p C
+ */
+template<typename... C>
+auto has( //
+	ecsact_system_execution_context* ctx
+) -> std::array<bool, sizeof...(C)> {
+	auto       result = std::array<bool, sizeof...(C)>{};
+	const auto component_ids = std::array{
+		ecsact_id_cast<ecsact_component_like_id>(C::id)...,
+	};
+
+	ecsact_system_execution_context_has_many(
+		ctx,
+		static_cast<int32_t>(sizeof...(C)),
+		component_ids.data(),
+		nullptr,
+		result.data()
+	);
+
+	return result;
+}
+
+/**
+ * Generates one entity per element of @p entities in a single host call.
+ */
+template<typename... C>
+auto generate_many(
+	ecsact_system_execution_context*  ctx,
+	std::span<const std::tuple<C...>> entities
+) -> void {
+	constexpr auto components_per_entity = static_cast<int32_t>(sizeof...(C));
+
+	auto components_counts = std::vector<int32_t>(
+		entities.size(),
+		components_per_entity
+	);
+	auto component_ids = std::vector<ecsact_component_id>{};
+	auto components_data = std::vector<const void*>{};
+	component_ids.reserve(entities.size() * sizeof...(C));
+	components_data.reserve(entities.size() * sizeof...(C));
+
+	for(const auto& entity_components : entities) {
+		(component_ids.push_back(ecsact_id_cast<ecsact_component_id>(C::id)), ...);
+		std::apply(
+			[&](const auto&... component) {
+				(components_data.push_back(&component), ...);
+			},
+			entity_components
+		);
+	}
+
+	ecsact_system_execution_context_generate_many(
+		ctx,
+		static_cast<int32_t>(entities.size()),
+		components_counts.data(),
+		component_ids.data(),
+		components_data.data()
+	);
+}
+
+/**
+ * Overloads accepting the C++ execution context wrappers (anything with a
+ * `_ctx` member, e.g. `ecsact::execution_context` or a generated system
+ * context.)
+ */
+template<typename... C, typename Context>
+	requires(!std::is_pointer_v<Context>)
+auto get(Context& ctx) -> std::tuple<C...> {
+	return get<C...>(ctx._ctx);
+}
+
+template<typename Context, typename... C>
+	requires(!std::is_pointer_v<Context>)
+auto update(Context& ctx, const C&... components) -> void {
+	update(ctx._ctx, components...);
+}
+
+template<typename... C, typename Context>
+	requires(!std::is_pointer_v<Context>)
+auto has(Context& ctx) -> std::array<bool, sizeof...(C)> {
+	return has<C...>(ctx._ctx);
+}
+
+template<typename Context, typename... C>
+	requires(!std::is_pointer_v<Context>)
+auto generate_many(
+	Context&                          ctx,
+	std::span<const std::tuple<C...>> entities
+) -> void {
+	generate_many(ctx._ctx, entities);
+}
+
+} // namespace ecsact::si::wasm::guest
@@ -0,0 +1,49 @@
+#ifndef ECSACT_SI_WASMER_LOAD_STATS_H
+#define ECSACT_SI_WASMER_LOAD_STATS_H
+
+#include <stdint.h>
+#include "ecsact/si/wasm.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Statistics about the last successful `ecsact_si_wasm_load`
+ */
+typedef struct ecsact_si_wasmer_load_stats {
+	/**
+	 * Number of module instances created for concurrent system execution
+	 */
+	int32_t instances_count;
+
+	/**
+	 * Number of systems passed to `ecsact_si_wasm_load`
+	 */
+	int32_t systems_count;
+
+	/**
+	 * Number of systems whose exported impl has an empty body. These systems
+	 * are registered with a host no-op and never enter the guest.
+	 */
+	int32_t elided_systems_count;
+} ecsact_si_wasmer_load_stats;
+
+ECSACT_SI_WASM_API void ecsact_si_wasmer_get_load_stats( //
+	ecsact_si_wasmer_load_stats* out_stats
+);
+
+/**
+ * Writes up to @p max_system_ids ids of the elided systems to
+ * @p out_system_ids. See `ecsact_si_wasmer_load_stats::elided_systems_count`.
+ */
+ECSACT_SI_WASM_API void ecsact_si_wasmer_get_elided_systems(
+	int32_t                max_system_ids,
+	ecsact_system_like_id* out_system_ids
+);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ECSACT_SI_WASMER_LOAD_STATS_H
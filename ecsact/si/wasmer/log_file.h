@@ -0,0 +1,82 @@
+#ifndef ECSACT_SI_WASMER_LOG_FILE_H
+#define ECSACT_SI_WASMER_LOG_FILE_H
+
+#include <stdint.h>
+#include "ecsact/si/wasm.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Binary log file layout. A file starts with a
+ * `ecsact_si_wasmer_log_file_header` followed by back to back records. Each
+ * record is a `ecsact_si_wasmer_log_file_record` followed by
+ * `message_length` bytes of guest output and padding up to `record_size`.
+ * All fields are little endian. Records are guest writes, not lines, so a
+ * record may hold several lines or part of one.
+ */
+#define ECSACT_SI_WASMER_LOG_FILE_MAGIC "ESWLOG01"
+
+typedef struct ecsact_si_wasmer_log_file_header {
+	char magic[8];
+
+	/**
+	 * Size of the file including this header
+	 */
+	uint64_t capacity;
+
+	/**
+	 * Bytes reserved for records after this header. May exceed the space left
+	 * in the file when writes were dropped.
+	 */
+	uint64_t write_offset;
+
+	/**
+	 * Writes dropped because the file was full
+	 */
+	uint64_t dropped_count;
+} ecsact_si_wasmer_log_file_header;
+
+typedef struct ecsact_si_wasmer_log_file_record {
+	/**
+	 * Size of the record including this header, a multiple of 8. Written last,
+	 * so `0` marks a record that was never completed.
+	 */
+	uint32_t record_size;
+	int32_t  log_level;
+	int32_t  system_id;
+	int32_t  entity;
+	int32_t  instance_index;
+	uint32_t message_length;
+	uint64_t thread_id;
+	int64_t  timestamp_ns;
+} ecsact_si_wasmer_log_file_record;
+
+/**
+ * Creates (or truncates) @p path with a size of @p capacity bytes and maps it
+ * into memory. Until `ecsact_si_wasmer_close_log_file` guest stdout/stderr
+ * writes are appended to it instead of being delivered to log consumers.
+ * Must not be called while systems are executing.
+ *
+ * @returns 0 on success or -1 if @p path is null, @p capacity is too small to
+ *          hold the file header or the file could not be created and mapped
+ */
+ECSACT_SI_WASM_API int32_t ecsact_si_wasmer_open_log_file(
+	const char* path,
+	int64_t     capacity
+);
+
+/**
+ * Unmaps the log file and shrinks it to the bytes used. Must not be called
+ * while systems are executing. Guest writes use the log file without taking a
+ * lock, so closing it while a system writes to stdout/stderr is a use after
+ * free.
+ */
+ECSACT_SI_WASM_API void ecsact_si_wasmer_close_log_file(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ECSACT_SI_WASMER_LOG_FILE_H
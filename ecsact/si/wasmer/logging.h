@@ -0,0 +1,157 @@
+#ifndef ECSACT_SI_WASMER_LOGGING_H
+#define ECSACT_SI_WASMER_LOGGING_H
+
+#include <stdint.h>
+#include "ecsact/si/wasm.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * What happens to guest stdout/stderr writes when the writing thread's log
+ * buffer is full. Buffers are emptied by `ecsact_si_wasm_consume_logs`.
+ */
+typedef enum ecsact_si_wasmer_log_overflow_policy {
+	/**
+	 * The new write is discarded (default)
+	 */
+	ECSACT_SI_WASMER_LOG_OVERFLOW_DROP_NEWEST = 0,
+
+	/**
+	 * The oldest unconsumed writes are discarded to make room
+	 */
+	ECSACT_SI_WASMER_LOG_OVERFLOW_DROP_OLDEST = 1,
+} ecsact_si_wasmer_log_overflow_policy;
+
+ECSACT_SI_WASM_API void ecsact_si_wasmer_set_log_overflow_policy(
+	ecsact_si_wasmer_log_overflow_policy policy
+);
+
+/**
+ * Size in bytes of each thread's log buffer. Only affects threads that have
+ * not logged yet. Default is 64 KiB.
+ */
+ECSACT_SI_WASM_API void ecsact_si_wasmer_set_log_buffer_size( //
+	int32_t buffer_size
+);
+
+/**
+ * Total number of guest stdout/stderr writes dropped because of a full log
+ * buffer.
+ */
+ECSACT_SI_WASM_API int64_t ecsact_si_wasmer_dropped_log_writes_count(void);
+
+/**
+ * Limits how many @p level lines @p system_id may write to stdout/stderr.
+ * Writes over the limit are dropped and only counted. A warning line
+ * summarizing the dropped count is delivered with the next consumed logs.
+ *
+ * @param system_id system to limit or -1 for every system without its own
+ *        limit
+ * @param max_lines_per_second most lines per second, `0` for unlimited
+ * @param sample_every only every Nth line is kept, `0` or `1` keeps all
+ *
+ * May be called while systems are executing. Lines suppressed by a replaced
+ * limit are still summarized.
+ */
+ECSACT_SI_WASM_API void ecsact_si_wasmer_set_log_rate_limit(
+	ecsact_system_like_id    system_id,
+	ecsact_si_wasm_log_level level,
+	int32_t                  max_lines_per_second,
+	int32_t                  sample_every
+);
+
+/**
+ * Removes every limit set by `ecsact_si_wasmer_set_log_rate_limit`. May be
+ * called while systems are executing. Lines suppressed by the removed limits
+ * are still summarized.
+ */
+ECSACT_SI_WASM_API void ecsact_si_wasmer_clear_log_rate_limits(void);
+
+/**
+ * Guest log line with attribution
+ */
+typedef struct ecsact_si_wasmer_log_record {
+	ecsact_si_wasm_log_level log_level;
+
+	/**
+	 * Line without the trailing newline. Only valid during the consumer call.
+	 */
+	const char* message;
+	int32_t     message_length;
+
+	/**
+	 * System whose impl wrote the line or -1 when written outside of a system
+	 * impl (e.g. module initialization)
+	 */
+	ecsact_system_like_id system_id;
+
+	/**
+	 * Entity the system impl was executing for or -1
+	 */
+	ecsact_entity_id entity;
+
+	/**
+	 * Index of the module instance that wrote the line
+	 */
+	int32_t instance_index;
+
+	/**
+	 * Opaque id of the host thread that wrote the line
+	 */
+	uint64_t thread_id;
+
+	/**
+	 * Monotonic (steady clock) time the line was started in nanoseconds
+	 */
+	int64_t timestamp_ns;
+} ecsact_si_wasmer_log_record;
+
+typedef void (*ecsact_si_wasmer_log_record_consumer)(
+	const ecsact_si_wasmer_log_record* record,
+	void*                              user_data
+);
+
+/**
+ * Same as `ecsact_si_wasm_consume_logs` but with attributed records
+ */
+ECSACT_SI_WASM_API void ecsact_si_wasmer_consume_log_records(
+	ecsact_si_wasmer_log_record_consumer consumer,
+	void*                                consumer_user_data
+);
+
+/**
+ * Starts delivering log lines to @p consumer from a dedicated thread every
+ * @p flush_interval_ms milliseconds. Guest logging never waits on
+ * @p consumer. Lines are still buffered in the bounded per-thread log buffers
+ * between flushes so size them (`ecsact_si_wasmer_set_log_buffer_size`) for
+ * the expected log volume per interval. Replaces any previously started
+ * stream.
+ */
+ECSACT_SI_WASM_API void ecsact_si_wasmer_start_log_stream(
+	ecsact_si_wasm_log_consumer consumer,
+	void*                       consumer_user_data,
+	int32_t                     flush_interval_ms
+);
+
+/**
+ * Same as `ecsact_si_wasmer_start_log_stream` but with attributed records
+ */
+ECSACT_SI_WASM_API void ecsact_si_wasmer_start_log_record_stream(
+	ecsact_si_wasmer_log_record_consumer consumer,
+	void*                                consumer_user_data,
+	int32_t                              flush_interval_ms
+);
+
+/**
+ * Delivers any remaining log lines to the streaming consumer and stops its
+ * thread. No-op if no stream was started.
+ */
+ECSACT_SI_WASM_API void ecsact_si_wasmer_stop_log_stream(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ECSACT_SI_WASMER_LOGGING_H
@@ -0,0 +1,145 @@
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <string_view>
+#include "ecsact/si/wasmer/detail/context_handles.hh"
+#include "ecsact/si/wasmer/detail/mem_stack.hh"
+
+using ecsact::wasm::detail::call_mem_alloc;
+using ecsact::wasm::detail::call_mem_pop_frame;
+using ecsact::wasm::detail::call_mem_push_frame;
+using ecsact::wasm::detail::call_mem_read;
+using ecsact::wasm::detail::context_handles;
+
+using context = ecsact_system_execution_context;
+
+constexpr auto assoc_a = static_cast<ecsact_system_assoc_id>(1);
+constexpr auto assoc_b = static_cast<ecsact_system_assoc_id>(2);
+
+/**
+ * Handles only store context pointers so any distinct addresses will do
+ */
+auto fake_contexts = std::array<std::int64_t, 3>{};
+
+auto fake_context(std::size_t index) -> const context* {
+	return reinterpret_cast<const context*>(&fake_contexts[index]);
+}
+
+auto failures = 0;
+
+auto expect(bool condition, std::string_view what) -> void {
+	if(!condition) {
+		std::cerr << "[TEST FAILED]: " << what << std::endl;
+		failures += 1;
+	}
+}
+
+/**
+ * @returns `true` if @p handle is in call memory and refers to @p ctx
+ */
+auto refers_to(std::int32_t handle, const context* ctx) -> bool {
+	auto stored = call_mem_read<context*>(handle);
+	return stored && *stored == ctx;
+}
+
+auto test_dedup(context_handles& handles) -> void {
+	auto a = fake_context(0);
+	auto b = fake_context(1);
+
+	expect(handles.get(nullptr) == 0, "null context handle");
+	expect(refers_to(0, nullptr), "handle 0 does not refer to a null context");
+
+	auto a_handle = handles.get(a);
+	auto b_handle = handles.get(b);
+	expect(a_handle > 0 && refers_to(a_handle, a), "first context handle");
+	expect(b_handle > 0 && refers_to(b_handle, b), "second context handle");
+	expect(a_handle != b_handle, "different contexts share a handle");
+	expect(handles.get(a) == a_handle, "same context got a new handle");
+	expect(handles.get(b) == b_handle, "same context got a new handle");
+
+	expect(!handles.find_other(a, assoc_a), "other found before it was cached");
+	handles.cache_other(a, assoc_a, b_handle);
+	expect(handles.find_other(a, assoc_a) == b_handle, "cached other");
+	expect(!handles.find_other(a, assoc_b), "other found for another assoc");
+	expect(!handles.find_other(b, assoc_a), "other found for another context");
+}
+
+auto test_truncate(context_handles& handles) -> void {
+	auto a = fake_context(0);
+	auto c = fake_context(2);
+	auto a_handle = handles.get(a);
+
+	auto frame = call_mem_push_frame();
+	auto c_handle = handles.get(c);
+	handles.cache_other(a, assoc_b, c_handle);
+	expect(handles.find_other(a, assoc_b) == c_handle, "other in nested frame");
+
+	call_mem_pop_frame(frame);
+	handles.truncate(frame.offset);
+
+	expect(
+		!handles.find_other(a, assoc_b),
+		"other from a popped frame survived truncate"
+	);
+	expect(
+		handles.find_other(a, assoc_a).has_value(),
+		"other from before the popped frame was truncated"
+	);
+	expect(
+		handles.get(a) == a_handle,
+		"context from before the popped frame got a new handle"
+	);
+
+	// The popped frame's memory is reused, so a stale handle would refer to
+	// whatever was allocated there next
+	auto reused = call_mem_alloc(std::int64_t{});
+	expect(
+		reused == c_handle,
+		"popped frame memory was not reused by the next allocation"
+	);
+	auto new_c_handle = handles.get(c);
+	expect(
+		new_c_handle != c_handle && refers_to(new_c_handle, c),
+		"context from a popped frame kept its stale handle"
+	);
+}
+
+auto test_reset(context_handles& handles) -> void {
+	auto a = fake_context(0);
+
+	auto frame = call_mem_push_frame();
+	handles.reset();
+
+	expect(
+		!handles.find_other(a, assoc_a),
+		"other from a previous call survived reset"
+	);
+	auto a_handle = handles.get(a);
+	expect(
+		a_handle > 0 && refers_to(a_handle, a),
+		"context after reset does not refer to its context"
+	);
+	expect(refers_to(0, nullptr), "reset did not reserve handle 0");
+
+	call_mem_pop_frame(frame);
+}
+
+auto main() -> int {
+	auto handles = context_handles{};
+
+	auto frame = call_mem_push_frame();
+	handles.reset();
+	test_dedup(handles);
+	test_truncate(handles);
+	call_mem_pop_frame(frame);
+
+	test_reset(handles);
+
+	if(failures > 0) {
+		return 1;
+	}
+
+	std::cout << "Test complete!\n";
+	return 0;
+}
@@ -0,0 +1,164 @@
+#include <vector>
+#include <string>
+#include <string_view>
+#include <filesystem>
+#include <iostream>
+#include <span>
+#include <array>
+#include <chrono>
+#include <format>
+#include "magic_enum.hpp"
+#include "ecsact/runtime/core.h"
+#include "ecsact/runtime/core.hh"
+#include "ecsact/si/wasm.hh"
+
+#include "example.ecsact.hh"
+
+namespace fs = std::filesystem;
+using namespace std::string_view_literals;
+using std::chrono::duration_cast;
+using std::chrono::microseconds;
+using std::chrono::steady_clock;
+
+constexpr auto SPAWNERS_PARAM_PREFIX = "--spawners="sv;
+constexpr auto TICKS_PARAM_PREFIX = "--ticks="sv;
+constexpr auto GENERATE_MANY_PARAM = "--generate-many"sv;
+
+// Entities each spawner generates per tick in example__GeneratorMany
+constexpr auto generate_many_batch_size = 4;
+
+// Only one generator is loaded so the other example systems (and their logs)
+// don't show up in the timings
+const auto generate_bench_systems = std::array{
+	ecsact::si::wasm::system_load_options{
+		ecsact_id_cast<ecsact_system_like_id>(example::Generator::id),
+		"example__Generator"sv,
+	},
+};
+
+const auto generate_many_bench_systems = std::array{
+	ecsact::si::wasm::system_load_options{
+		ecsact_id_cast<ecsact_system_like_id>(example::GeneratorMany::id),
+		"example__GeneratorMany"sv,
+	},
+};
+
+struct bench_options {
+	std::string wasm_path;
+	int         spawners = 1000;
+	int         ticks = 100;
+	bool        generate_many = false;
+};
+
+[[noreturn]] auto usage_error(const char* exe, std::string_view message)
+	-> void {
+	std::cerr //
+		<< "[ERROR] " << message << "\n"
+		<< "Usage: " << exe << " [" << SPAWNERS_PARAM_PREFIX << "N] ["
+		<< TICKS_PARAM_PREFIX << "N] [" << GENERATE_MANY_PARAM << "] <wasm-file>\n";
+	std::exit(1);
+}
+
+auto parse_args(int argc, char* argv[]) -> bench_options {
+	auto options = bench_options{};
+
+	for(int i = 1; argc > i; ++i) {
+		std::string arg(argv[i]);
+
+		if(arg.starts_with(SPAWNERS_PARAM_PREFIX)) {
+			options.spawners = std::stoi(arg.substr(SPAWNERS_PARAM_PREFIX.size()));
+		} else if(arg.starts_with(TICKS_PARAM_PREFIX)) {
+			options.ticks = std::stoi(arg.substr(TICKS_PARAM_PREFIX.size()));
+		} else if(arg == GENERATE_MANY_PARAM) {
+			options.generate_many = true;
+		} else if(arg.starts_with('-')) {
+			usage_error(argv[0], "Unknown arg: " + arg);
+		} else {
+			options.wasm_path = arg;
+		}
+	}
+
+	if(options.wasm_path.empty()) {
+		usage_error(argv[0], "Missing wasm file path");
+	}
+
+	// Per tick timings divide by the tick count
+	if(options.ticks <= 0) {
+		usage_error(argv[0], "--ticks must be at least 1");
+	}
+
+	if(!fs::exists(options.wasm_path)) {
+		std::cerr << "[ERROR] " << options.wasm_path << " does not exist\n";
+		std::exit(1);
+	}
+
+	return options;
+}
+
+int main(int argc, char* argv[]) {
+	std::ios_base::sync_with_stdio(false);
+
+	auto options = parse_args(argc, argv);
+
+	auto bench_systems = options.generate_many
+		? std::span{generate_many_bench_systems}
+		: std::span{generate_bench_systems};
+	auto generated_per_spawner = options.generate_many //
+		? generate_many_batch_size
+		: 1;
+
+	auto err = ecsact::si::wasm::load_file(options.wasm_path, bench_systems);
+	if(err != ECSACT_SI_WASM_OK) {
+		std::cerr << std::format(
+			"[ERROR] loading wasm file {} failed: {}\n{}\n",
+			options.wasm_path,
+			magic_enum::enum_name(err),
+			ecsact::si::wasm::last_error_message()
+		);
+		return 2;
+	}
+
+	ecsact::core::registry bench_registry("Generator Bench Registry");
+
+	for(auto i = 0; options.spawners > i; ++i) {
+		auto entity = bench_registry.create_entity();
+		bench_registry.add_component(entity, example::Spawner{});
+		bench_registry.add_component(entity, example::ExampleComponent{});
+	}
+
+	auto total_time = microseconds{};
+	for(auto i = 0; options.ticks > i; ++i) {
+		auto start = steady_clock::now();
+		ecsact_execute_systems(bench_registry.id(), 1, nullptr, nullptr);
+		total_time += duration_cast<microseconds>(steady_clock::now() - start);
+	}
+
+	ecsact::si::wasm::consume_and_print_logs();
+
+	auto generated_count = static_cast<std::int64_t>(options.spawners) *
+		options.ticks * generated_per_spawner;
+	auto entities_count = ecsact_count_entities(bench_registry.id());
+	if(entities_count != options.spawners + generated_count) {
+		std::cerr << std::format(
+			"[ERROR] expected {} entities after {} ticks, found {}\n",
+			options.spawners + generated_count,
+			options.ticks,
+			entities_count
+		);
+		return 3;
+	}
+
+	std::cout << std::format(
+		"[BENCH] example.{} spawners={} ticks={} total={}us "
+		"per_tick={}us per_generate={:.3f}us\n",
+		options.generate_many ? "GeneratorMany" : "Generator",
+		options.spawners,
+		options.ticks,
+		total_time.count(),
+		total_time.count() / options.ticks,
+		static_cast<double>(total_time.count()) /
+			static_cast<double>(generated_count)
+	);
+
+	return 0;
+}
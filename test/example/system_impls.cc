@@ -1,9 +1,13 @@
 #include "example.ecsact.hh"
 #include "example.ecsact.systems.hh"
 
+#include <array>
 #include <iostream>
 #include <cstdio>
+#include <span>
 #include <string>
+#include <tuple>
+#include "ecsact/si/wasmer/guest/execution_context.hh"
 
 void example__ExampleSystem(ecsact_system_execution_context* c_ctx) {
 	example::ExampleSystem::context ctx{ecsact::execution_context{c_ctx}};
@@ -27,6 +31,26 @@ void example::Generator::impl(context& ctx) {
 	ctx._ctx.generate(example::WillAdd{42});
 }
 
+void example__GeneratorMany(ecsact_system_execution_context* c_ctx) {
+	example::GeneratorMany::context ctx{ecsact::execution_context{c_ctx}};
+	example::GeneratorMany::impl(ctx);
+}
+
+void example::GeneratorMany::impl(context& ctx) {
+	// Keep in sync with generate_many_batch_size in generator_bench.cc
+	static const auto entities = std::array{
+		std::tuple{example::WillAdd{42}},
+		std::tuple{example::WillAdd{43}},
+		std::tuple{example::WillAdd{44}},
+		std::tuple{example::WillAdd{45}},
+	};
+
+	ecsact::si::wasm::guest::generate_many(
+		ctx,
+		std::span<const std::tuple<example::WillAdd>>{entities}
+	);
+}
+
 void example__AddsSystem(ecsact_system_execution_context* c_ctx) {
 	example::AddsSystem::context ctx{ecsact::execution_context{c_ctx}};
 	example::AddsSystem::impl(ctx);
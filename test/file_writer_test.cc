@@ -0,0 +1,159 @@
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <span>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include "ecsact/si/wasmer/detail/file_writer.hh"
+
+namespace fs = std::filesystem;
+
+using ecsact::wasm::detail::file_writer;
+
+constexpr auto threads_count = 8;
+constexpr auto appends_per_thread = 2000;
+
+/**
+ * Larger than the pending bytes a thread may buffer in file_writer.cc
+ */
+constexpr auto oversized_append = std::size_t{64 * 1024 * 1024 + 1};
+
+auto failures = 0;
+
+auto expect(bool condition, std::string_view what) -> void {
+	if(!condition) {
+		std::cerr << "[TEST FAILED]: " << what << std::endl;
+		failures += 1;
+	}
+}
+
+auto as_bytes(std::string_view str) -> std::span<const std::byte> {
+	return {reinterpret_cast<const std::byte*>(str.data()), str.size()};
+}
+
+/**
+ * Each thread appends lines `<thread> <sequence>` one append at a time while
+ * the flush thread and the main thread flush concurrently
+ */
+auto test_per_thread_order(file_writer& writer, const fs::path& dir) -> void {
+	auto path = dir / "order.txt";
+	auto file_id = writer.open(path.string());
+	if(file_id == -1) {
+		expect(false, "open " + path.string());
+		return;
+	}
+
+	auto small_drops = std::atomic_int{};
+	auto threads = std::vector<std::jthread>{};
+	for(auto t = 0; threads_count > t; ++t) {
+		threads.emplace_back([&, t] {
+			for(auto i = 0; appends_per_thread > i; ++i) {
+				auto line = std::to_string(t) + " " + std::to_string(i) + "\n";
+				if(!writer.append(file_id, as_bytes(line))) {
+					small_drops += 1;
+				}
+			}
+		});
+	}
+
+	for(auto i = 0; 10 > i; ++i) {
+		writer.flush();
+		std::this_thread::sleep_for(std::chrono::milliseconds{1});
+	}
+	threads.clear();
+	writer.flush();
+	expect(small_drops == 0, "append dropped a small write");
+
+	auto file = std::ifstream{path};
+	auto next_sequence = std::vector<int>(threads_count, 0);
+	auto line = std::string{};
+	auto malformed = 0;
+	while(std::getline(file, line)) {
+		auto line_stream = std::istringstream{line};
+		auto thread = -1;
+		auto sequence = -1;
+		if(!(line_stream >> thread >> sequence) || thread < 0 ||
+			 thread >= threads_count) {
+			malformed += 1;
+			continue;
+		}
+
+		if(sequence != next_sequence[thread]) {
+			expect(false, "out of order line: " + line);
+		}
+		next_sequence[thread] = sequence + 1;
+	}
+
+	expect(malformed == 0, "writes from different threads were interleaved");
+	for(auto t = 0; threads_count > t; ++t) {
+		if(next_sequence[t] != appends_per_thread) {
+			expect(false, "missing writes of thread " + std::to_string(t));
+		}
+	}
+}
+
+auto test_dropped_bytes(file_writer& writer, const fs::path& dir) -> void {
+	auto path = dir / "dropped.txt";
+	auto file_id = writer.open(path.string());
+	if(file_id == -1) {
+		expect(false, "open " + path.string());
+		return;
+	}
+
+	auto dropped_before = writer.dropped_bytes();
+	auto oversized = std::vector<std::byte>(oversized_append, std::byte{'x'});
+
+	expect(writer.append(file_id, as_bytes("kept\n")), "append before the drop");
+	expect(
+		!writer.append(file_id, oversized),
+		"oversized append was not dropped"
+	);
+	expect(writer.append(file_id, as_bytes("also kept\n")), "append after drop");
+	writer.flush();
+
+	expect(
+		writer.dropped_bytes() - dropped_before == oversized_append,
+		"dropped_bytes does not count the dropped append"
+	);
+
+	auto file = std::ifstream{path, std::ios::binary};
+	auto content = std::string{
+		std::istreambuf_iterator<char>{file},
+		std::istreambuf_iterator<char>{},
+	};
+	expect(content == "kept\nalso kept\n", "dropped append reached the file");
+}
+
+auto main() -> int {
+	auto tmp_dir = std::getenv("TEST_TMPDIR");
+	auto test_dir = (tmp_dir ? fs::path{tmp_dir} : fs::temp_directory_path()) /
+		"ecsact_si_wasmer_file_writer_test";
+	fs::remove_all(test_dir);
+	fs::create_directories(test_dir);
+
+	{
+		// Thread buffers bind to the first writer they append to, so one writer
+		// for the whole test
+		auto writer = file_writer{std::chrono::milliseconds{1}};
+		test_per_thread_order(writer, test_dir);
+		test_dropped_bytes(writer, test_dir);
+	}
+
+	fs::remove_all(test_dir);
+
+	if(failures > 0) {
+		return 1;
+	}
+
+	std::cout << "Test complete!\n";
+	return 0;
+}
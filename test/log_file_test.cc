@@ -0,0 +1,182 @@
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include "ecsact/si/wasmer/log_file.h"
+#include "ecsact/si/wasmer/detail/log_file_sink.hh"
+
+namespace fs = std::filesystem;
+
+using ecsact::wasm::detail::log_attribution;
+using ecsact::wasm::detail::log_file_sink;
+
+constexpr auto header_size = sizeof(ecsact_si_wasmer_log_file_header);
+constexpr auto record_header_size = sizeof(ecsact_si_wasmer_log_file_record);
+
+auto failures = 0;
+
+auto expect(bool condition, std::string_view what) -> void {
+	if(!condition) {
+		std::cerr << "[TEST FAILED]: " << what << std::endl;
+		failures += 1;
+	}
+}
+
+auto read_file(const fs::path& p) -> std::string {
+	auto file = std::ifstream{p, std::ios::binary};
+	return std::string{
+		std::istreambuf_iterator<char>{file},
+		std::istreambuf_iterator<char>{},
+	};
+}
+
+auto attribution(std::int64_t timestamp_ns) -> log_attribution {
+	return log_attribution{
+		.system_id = static_cast<ecsact_system_like_id>(3),
+		.entity = static_cast<ecsact_entity_id>(7),
+		.instance_index = 0,
+		.thread_id = 1,
+		.timestamp_ns = timestamp_ns,
+	};
+}
+
+/**
+ * Text line the reader prints for a line started by the write with
+ * @p timestamp_ns
+ */
+auto reader_line(
+	std::int64_t     timestamp_ns,
+	std::string_view level,
+	std::string_view line
+) -> std::string {
+	return std::to_string(timestamp_ns) + " " + std::string{level} +
+		" system=3 entity=7 instance=0 thread=1: " + std::string{line} + "\n";
+}
+
+struct reader_output {
+	int         exit_code;
+	std::string out;
+	std::string err;
+};
+
+/**
+ * Runs the log file reader tool on @p log_path
+ */
+auto run_reader(const fs::path& reader, const fs::path& log_path)
+	-> reader_output {
+	auto out_path = fs::path{log_path}.replace_extension(".out");
+	auto err_path = fs::path{log_path}.replace_extension(".err");
+	auto cmd = "\"" + reader.string() + "\" \"" + log_path.string() + "\" > \"" +
+		out_path.string() + "\" 2> \"" + err_path.string() + "\"";
+#ifdef _WIN32
+	// cmd.exe strips the outermost quotes of the command
+	cmd = "\"" + cmd + "\"";
+#endif
+
+	auto exit_code = std::system(cmd.c_str());
+	return {exit_code, read_file(out_path), read_file(err_path)};
+}
+
+auto test_round_trip(const fs::path& reader, const fs::path& dir) -> void {
+	auto log_path = dir / "round_trip.log";
+	auto sink = log_file_sink::open(log_path.string(), 4096);
+	if(!sink) {
+		expect(false, "log_file_sink::open " + log_path.string());
+		return;
+	}
+
+	constexpr auto info = ECSACT_SI_WASM_LOG_LEVEL_INFO;
+	constexpr auto error = ECSACT_SI_WASM_LOG_LEVEL_ERROR;
+	expect(sink->write(info, attribution(1), "hello\n"), "write 1");
+	expect(sink->write(info, attribution(2), "wor"), "write 2");
+	expect(sink->write(info, attribution(3), "ld\nbye"), "write 3");
+	expect(sink->write(error, attribution(4), "oops\n"), "write 4");
+	sink.reset();
+
+	auto output = run_reader(reader, log_path);
+	expect(output.exit_code == 0, "reader failed");
+	expect(
+		output.out ==
+			reader_line(1, "INFO", "hello") + reader_line(2, "INFO", "world") +
+				reader_line(4, "ERROR", "oops") + reader_line(3, "INFO", "bye"),
+		"reader output does not match the writes:\n" + output.out
+	);
+	expect(output.err.empty(), "reader reported errors:\n" + output.err);
+}
+
+auto test_full_file(const fs::path& reader, const fs::path& dir) -> void {
+	auto message = std::string_view{"line\n"};
+	auto record_size = record_header_size + message.size();
+	record_size = (record_size + 7) & ~std::size_t{7};
+
+	// Room for 3 records and a tail large enough to read as an empty record
+	auto capacity = header_size + 3 * record_size + record_header_size;
+
+	auto log_path = dir / "full.log";
+	auto sink = log_file_sink::open(log_path.string(), capacity);
+	if(!sink) {
+		expect(false, "log_file_sink::open " + log_path.string());
+		return;
+	}
+
+	auto written = 0;
+	auto dropped = 0;
+	for(auto i = 0; 5 > i; ++i) {
+		auto level = ECSACT_SI_WASM_LOG_LEVEL_INFO;
+		if(sink->write(level, attribution(i), message)) {
+			written += 1;
+		} else {
+			dropped += 1;
+		}
+	}
+	sink.reset();
+
+	expect(written == 3 && dropped == 2, "full log file kept the wrong writes");
+	expect(
+		fs::file_size(log_path) == capacity,
+		"full log file was not kept at its capacity"
+	);
+
+	auto output = run_reader(reader, log_path);
+	expect(output.exit_code == 0, "reader failed on a full log file");
+	expect(
+		output.out == reader_line(0, "INFO", "line") +
+				reader_line(1, "INFO", "line") + reader_line(2, "INFO", "line"),
+		"reader output of a full log file:\n" + output.out
+	);
+	expect(
+		output.err == "2 write(s) dropped because the log file was full\n",
+		"reader errors for a full log file:\n" + output.err
+	);
+}
+
+auto main(int argc, char* argv[]) -> int {
+	if(argc != 2) {
+		std::cerr << "Usage: " << argv[0] << " <log_file_reader>\n";
+		return 1;
+	}
+
+	auto reader = fs::path{argv[1]}.make_preferred();
+	auto tmp_dir = std::getenv("TEST_TMPDIR");
+	auto test_dir = (tmp_dir ? fs::path{tmp_dir} : fs::temp_directory_path()) /
+		"ecsact_si_wasmer_log_file_test";
+	fs::remove_all(test_dir);
+	fs::create_directories(test_dir);
+
+	test_round_trip(reader, test_dir);
+	test_full_file(reader, test_dir);
+
+	fs::remove_all(test_dir);
+
+	if(failures > 0) {
+		return 1;
+	}
+
+	std::cout << "Test complete!\n";
+	return 0;
+}
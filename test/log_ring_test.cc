@@ -0,0 +1,157 @@
+#include <cstddef>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "ecsact/si/wasmer/detail/log_ring.hh"
+
+using ecsact::wasm::detail::log_attribution;
+using ecsact::wasm::detail::log_overflow_policy;
+using ecsact::wasm::detail::log_ring;
+
+constexpr auto drop_newest = log_overflow_policy::drop_newest;
+constexpr auto drop_oldest = log_overflow_policy::drop_oldest;
+
+/**
+ * Small enough that only a fraction of the pushed records fit
+ */
+constexpr auto ring_capacity = std::size_t{1024};
+constexpr auto push_count = 100;
+
+auto failures = 0;
+
+auto expect(bool condition, std::string_view what) -> void {
+	if(!condition) {
+		std::cerr << "[TEST FAILED]: " << what << std::endl;
+		failures += 1;
+	}
+}
+
+auto level_of(int number) -> ecsact_si_wasm_log_level {
+	return number % 2 //
+		? ECSACT_SI_WASM_LOG_LEVEL_ERROR
+		: ECSACT_SI_WASM_LOG_LEVEL_INFO;
+}
+
+struct drained_record {
+	ecsact_si_wasm_log_level level;
+	ecsact_entity_id         entity;
+	std::string              str;
+};
+
+auto drain_all(log_ring& ring) -> std::vector<drained_record> {
+	auto records = std::vector<drained_record>{};
+	ring.drain([&](auto level, const log_attribution& attribution, auto str) {
+		records.push_back({level, attribution.entity, std::string{str}});
+	});
+	return records;
+}
+
+/**
+ * Pushes `push_count` records numbered from @p first. The record number is
+ * both the string and the attributed entity.
+ * @returns total dropped count reported by `log_ring::push`
+ */
+auto push_numbered(log_ring& ring, int first, log_overflow_policy policy)
+	-> std::size_t {
+	auto dropped = std::size_t{};
+	for(auto i = first; first + push_count > i; ++i) {
+		auto attribution = log_attribution{
+			.entity = static_cast<ecsact_entity_id>(i),
+		};
+		auto str = std::to_string(i);
+		dropped += ring.push(level_of(i), attribution, str, policy);
+	}
+	return dropped;
+}
+
+/**
+ * @returns `true` if @p records are the consecutive numbers starting at
+ *          @p first with their level and attribution intact
+ */
+auto is_numbered_run(const std::vector<drained_record>& records, int first)
+	-> bool {
+	for(auto i = std::size_t{}; records.size() > i; ++i) {
+		auto number = first + static_cast<int>(i);
+		auto& record = records[i];
+		if(record.str != std::to_string(number) ||
+			 record.level != level_of(number) ||
+			 record.entity != static_cast<ecsact_entity_id>(number)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+auto test_drop_newest() -> void {
+	auto ring = log_ring{ring_capacity};
+
+	// Twice so the second run wraps around the end of the ring
+	for(auto first : {0, push_count}) {
+		auto dropped = push_numbered(ring, first, drop_newest);
+		auto records = drain_all(ring);
+
+		expect(!records.empty(), "drop_newest kept no records");
+		expect(dropped > 0, "drop_newest dropped no records");
+		expect(
+			records.size() + dropped == push_count,
+			"drop_newest dropped count does not match the missing records"
+		);
+		expect(
+			is_numbered_run(records, first),
+			"drop_newest did not keep the oldest records in order"
+		);
+	}
+}
+
+auto test_drop_oldest() -> void {
+	auto ring = log_ring{ring_capacity};
+
+	for(auto first : {0, push_count}) {
+		auto dropped = push_numbered(ring, first, drop_oldest);
+		auto records = drain_all(ring);
+
+		expect(!records.empty(), "drop_oldest kept no records");
+		expect(dropped > 0, "drop_oldest dropped no records");
+		expect(
+			records.size() + dropped == push_count,
+			"drop_oldest dropped count does not match the missing records"
+		);
+		auto kept_first = first + push_count - static_cast<int>(records.size());
+		expect(
+			is_numbered_run(records, kept_first),
+			"drop_oldest did not keep the newest records in order"
+		);
+	}
+}
+
+auto test_oversized_record() -> void {
+	auto ring = log_ring{ring_capacity};
+	auto oversized = std::string(ring_capacity, 'x');
+
+	for(auto policy : {drop_newest, drop_oldest}) {
+		ring.push(ECSACT_SI_WASM_LOG_LEVEL_INFO, {}, "kept", policy);
+		auto dropped =
+			ring.push(ECSACT_SI_WASM_LOG_LEVEL_INFO, {}, oversized, policy);
+		auto records = drain_all(ring);
+
+		expect(dropped == 1, "oversized record was not reported as dropped");
+		expect(
+			records.size() == 1 && records[0].str == "kept",
+			"oversized record displaced other records"
+		);
+	}
+}
+
+auto main() -> int {
+	test_drop_newest();
+	test_drop_oldest();
+	test_oversized_record();
+
+	if(failures > 0) {
+		return 1;
+	}
+
+	std::cout << "Test complete!\n";
+	return 0;
+}
@@ -0,0 +1,125 @@
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <string_view>
+#include "ecsact/si/wasmer/detail/mem_stack.hh"
+
+using ecsact::wasm::detail::call_mem_alloc;
+using ecsact::wasm::detail::call_mem_pop_frame;
+using ecsact::wasm::detail::call_mem_push_frame;
+using ecsact::wasm::detail::call_mem_read;
+
+/**
+ * Allocation sizes are already a multiple of the call memory granule so the
+ * expected high-water marks are plain sums
+ */
+struct small_block {
+	std::array<std::byte, 8> data;
+};
+
+struct large_block {
+	std::array<std::byte, 96> data;
+};
+
+auto failures = 0;
+
+auto expect(bool condition, std::string_view what) -> void {
+	if(!condition) {
+		std::cerr << "[TEST FAILED]: " << what << std::endl;
+		failures += 1;
+	}
+}
+
+auto test_nested_high_water_mark() -> void {
+	auto outer = call_mem_push_frame();
+	call_mem_alloc(small_block{});
+	call_mem_alloc(small_block{});
+
+	auto inner = call_mem_push_frame();
+	auto inner_offset = call_mem_alloc(large_block{});
+	expect(
+		inner_offset == 2 * sizeof(small_block),
+		"nested frame did not continue after the outer allocations"
+	);
+	expect(
+		call_mem_pop_frame(inner) == sizeof(large_block),
+		"nested frame high-water mark"
+	);
+	expect(
+		call_mem_read<large_block>(inner_offset) == nullptr,
+		"nested frame allocation readable after the frame was popped"
+	);
+
+	// Reuses the memory the nested frame released
+	expect(
+		call_mem_alloc(small_block{}) == inner_offset,
+		"outer allocation after a pop did not reuse the released memory"
+	);
+
+	expect(
+		call_mem_pop_frame(outer) == 2 * sizeof(small_block) + sizeof(large_block),
+		"outer frame high-water mark does not include the nested frame"
+	);
+}
+
+auto test_sibling_frames() -> void {
+	auto outer = call_mem_push_frame();
+
+	auto first = call_mem_push_frame();
+	call_mem_alloc(large_block{});
+	call_mem_alloc(large_block{});
+	expect(
+		call_mem_pop_frame(first) == 2 * sizeof(large_block),
+		"first sibling frame high-water mark"
+	);
+
+	// A later, smaller frame does not inherit the earlier frame's mark
+	auto second = call_mem_push_frame();
+	call_mem_alloc(small_block{});
+	expect(
+		call_mem_pop_frame(second) == sizeof(small_block),
+		"second sibling frame high-water mark"
+	);
+
+	expect(
+		call_mem_pop_frame(outer) == 2 * sizeof(large_block),
+		"outer frame high-water mark is not the largest sibling"
+	);
+}
+
+auto test_pop_skipping_frames() -> void {
+	auto outer = call_mem_push_frame();
+	call_mem_alloc(small_block{});
+	call_mem_push_frame();
+	call_mem_alloc(large_block{});
+
+	// Popping the outer frame pops the nested one still pushed
+	expect(
+		call_mem_pop_frame(outer) == sizeof(small_block) + sizeof(large_block),
+		"popping an outer frame with a nested frame still pushed"
+	);
+
+	auto next = call_mem_push_frame();
+	expect(
+		call_mem_alloc(small_block{}) == 0,
+		"call memory not released after every frame was popped"
+	);
+	expect(
+		call_mem_pop_frame(next) == sizeof(small_block),
+		"high-water mark of a frame pushed on an empty stack"
+	);
+}
+
+auto main() -> int {
+	test_nested_high_water_mark();
+	test_sibling_frames();
+	test_pop_skipping_frames();
+
+	if(failures > 0) {
+		return 1;
+	}
+
+	std::cout << "Test complete!\n";
+	return 0;
+}
@@ -0,0 +1,191 @@
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <string_view>
+#include <vector>
+#include "ecsact/si/wasmer/detail/mem_stack.hh"
+
+using ecsact::wasm::detail::call_mem_alloc;
+using ecsact::wasm::detail::call_mem_invalid_offset;
+using ecsact::wasm::detail::call_mem_pop_frame;
+using ecsact::wasm::detail::call_mem_push_frame;
+using ecsact::wasm::detail::call_mem_read;
+
+/**
+ * Must match the segment layout in mem_stack.cc
+ */
+constexpr auto segment_size = std::size_t{4096};
+constexpr auto max_segments = std::size_t{64};
+
+/**
+ * Two of these do not fit in one segment
+ */
+constexpr auto large_size = segment_size / 2 + 8;
+
+template<std::size_t Size>
+struct block {
+	std::array<std::byte, Size> data;
+
+	auto operator==(const block&) const -> bool = default;
+};
+
+auto failures = 0;
+
+auto expect(bool condition, std::string_view what) -> void {
+	if(!condition) {
+		std::cerr << "[TEST FAILED]: " << what << std::endl;
+		failures += 1;
+	}
+}
+
+template<std::size_t Size>
+auto filled_block(std::size_t value) -> block<Size> {
+	auto b = block<Size>{};
+	b.data.fill(static_cast<std::byte>(value));
+	return b;
+}
+
+template<std::size_t Size>
+auto is_filled(std::int32_t offset, std::size_t value) -> bool {
+	auto b = call_mem_read<block<Size>>(offset);
+	return b && *b == filled_block<Size>(value);
+}
+
+auto test_segment_rollover() -> void {
+	auto frame = call_mem_push_frame();
+
+	auto first = call_mem_alloc(filled_block<large_size>(1));
+	auto second = call_mem_alloc(filled_block<large_size>(2));
+	auto small = call_mem_alloc(std::int32_t{3});
+
+	expect(first == 0, "first allocation is not at the start");
+	expect(
+		second == static_cast<std::int32_t>(segment_size),
+		"allocation that does not fit did not move to the next segment"
+	);
+	expect(
+		small == second + static_cast<std::int32_t>(large_size),
+		"allocation after a rollover is not packed after the previous one"
+	);
+
+	expect(
+		is_filled<large_size>(first, 1),
+		"first segment contents changed by the rollover"
+	);
+	expect(is_filled<large_size>(second, 2), "second segment contents");
+	expect(
+		call_mem_read<std::int32_t>(small) &&
+			*call_mem_read<std::int32_t>(small) == 3,
+		"small allocation after the rollover"
+	);
+
+#ifdef ECSACT_SI_WASMER_CALL_MEM_VALIDATION
+	// The skipped tail of the first segment was never allocated
+	auto tail = first + static_cast<std::int32_t>(large_size);
+	expect(
+		call_mem_read<std::int32_t>(tail) == nullptr,
+		"read of the skipped segment tail"
+	);
+#endif
+
+	call_mem_pop_frame(frame);
+}
+
+auto test_exhaustion() -> void {
+	auto frame = call_mem_push_frame();
+
+	auto offsets = std::vector<std::int32_t>{};
+	for(;;) {
+		auto offset = call_mem_alloc(filled_block<segment_size>(offsets.size()));
+		if(offset == call_mem_invalid_offset) {
+			break;
+		}
+		offsets.push_back(offset);
+		if(offsets.size() > max_segments) {
+			break;
+		}
+	}
+
+	expect(
+		offsets.size() == max_segments,
+		"call memory did not run out after the last segment"
+	);
+	expect(
+		call_mem_alloc(std::int32_t{}) == call_mem_invalid_offset,
+		"small allocation after call memory ran out"
+	);
+
+	for(auto i = std::size_t{}; offsets.size() > i; ++i) {
+		if(!is_filled<segment_size>(offsets[i], i)) {
+			expect(false, "segment contents after call memory ran out");
+			break;
+		}
+	}
+
+	call_mem_pop_frame(frame);
+
+	// Popping the frame makes the segments available again
+	frame = call_mem_push_frame();
+	expect(
+		call_mem_alloc(filled_block<segment_size>(0)) == 0,
+		"allocation after popping an exhausted frame"
+	);
+	call_mem_pop_frame(frame);
+}
+
+auto test_oversized_allocation() -> void {
+	auto frame = call_mem_push_frame();
+	expect(
+		call_mem_alloc(block<segment_size + 1>{}) == call_mem_invalid_offset,
+		"allocation larger than a segment"
+	);
+	expect(
+		call_mem_alloc(std::int32_t{}) == 0,
+		"failed allocation used call memory"
+	);
+	call_mem_pop_frame(frame);
+}
+
+auto test_invalid_reads() -> void {
+	auto frame = call_mem_push_frame();
+	auto offset = call_mem_alloc(std::int64_t{42});
+
+	expect(call_mem_read<std::int64_t>(offset) != nullptr, "valid read");
+	expect(call_mem_read<std::int64_t>(-8) == nullptr, "negative offset read");
+	expect(call_mem_read<std::int32_t>(4) == nullptr, "unaligned read");
+	expect(
+		call_mem_read<std::int64_t>(offset + 8) == nullptr,
+		"read past the top of call memory"
+	);
+	expect(
+		call_mem_read<std::int64_t>(call_mem_invalid_offset) == nullptr,
+		"read of the invalid offset"
+	);
+#ifdef ECSACT_SI_WASMER_CALL_MEM_VALIDATION
+	expect(
+		call_mem_read<double>(offset) == nullptr,
+		"read with a different type than allocated"
+	);
+#endif
+
+	call_mem_pop_frame(frame);
+	expect(
+		call_mem_read<std::int64_t>(offset) == nullptr,
+		"read after the frame was popped"
+	);
+}
+
+auto main() -> int {
+	test_segment_rollover();
+	test_exhaustion();
+	test_oversized_allocation();
+	test_invalid_reads();
+
+	if(failures > 0) {
+		return 1;
+	}
+
+	std::cout << "Test complete!\n";
+	return 0;
+}
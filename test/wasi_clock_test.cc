@@ -0,0 +1,178 @@
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <span>
+#include <string_view>
+#include "ecsact/si/wasmer/detail/wasi_clock.hh"
+
+namespace wasi_clock = ecsact::wasm::detail::wasi::clock;
+
+using clockid = ecsact_si_wasi_clockid;
+using wasi_errno = ecsact_si_wasi_errno;
+
+constexpr auto all_clocks = std::array{
+	clockid::realtime,
+	clockid::monotonic,
+	clockid::process_cputime_id,
+	clockid::thread_cputime_id,
+};
+
+constexpr auto system_a = static_cast<ecsact_system_like_id>(10);
+constexpr auto system_b = static_cast<ecsact_system_like_id>(11);
+constexpr auto entity_a = static_cast<ecsact_entity_id>(20);
+constexpr auto entity_b = static_cast<ecsact_entity_id>(21);
+
+/**
+ * Not a multiple of the 8 byte words random bytes are generated in
+ */
+using random_bytes = std::array<std::byte, 13>;
+
+auto failures = 0;
+
+auto expect(bool condition, std::string_view what) -> void {
+	if(!condition) {
+		std::cerr << "[TEST FAILED]: " << what << std::endl;
+		failures += 1;
+	}
+}
+
+/**
+ * @returns `true` if every clock reports @p expected_ns
+ */
+auto clocks_are(std::uint64_t expected_ns) -> bool {
+	for(auto id : all_clocks) {
+		auto time = std::uint64_t{};
+		if(wasi_clock::time_get(id, time) != wasi_errno::success) {
+			return false;
+		}
+		if(time != expected_ns) {
+			return false;
+		}
+	}
+	return true;
+}
+
+auto random_for(
+	ecsact_system_like_id system_id,
+	ecsact_entity_id      entity,
+	std::uint64_t         counter = 0
+) -> random_bytes {
+	auto bytes = random_bytes{};
+	wasi_clock::random_get(system_id, entity, counter, bytes);
+	return bytes;
+}
+
+auto test_deterministic_time() -> void {
+	wasi_clock::enable_deterministic(1000, 1);
+	expect(clocks_are(0), "deterministic clocks do not start at 0");
+
+	wasi_clock::advance_ticks(3);
+	expect(clocks_are(3000), "deterministic clocks after 3 ticks");
+
+	wasi_clock::advance_ticks(-5);
+	expect(clocks_are(3000), "negative ticks moved the clocks");
+	wasi_clock::advance_ticks(0);
+	expect(clocks_are(3000), "zero ticks moved the clocks");
+
+	for(auto id : all_clocks) {
+		auto resolution = std::uint64_t{};
+		expect(
+			wasi_clock::res_get(id, resolution) == wasi_errno::success &&
+				resolution == 1000,
+			"deterministic clock resolution is not the tick duration"
+		);
+	}
+
+	auto time = std::uint64_t{};
+	expect(
+		wasi_clock::time_get(static_cast<clockid>(4), time) == wasi_errno::inval,
+		"unknown clock"
+	);
+
+	// Re-enabling starts over
+	wasi_clock::enable_deterministic(1000, 1);
+	expect(clocks_are(0), "re-enabled deterministic clocks do not start at 0");
+
+	wasi_clock::enable_deterministic(0, 1);
+	wasi_clock::advance_ticks(2);
+	expect(clocks_are(2), "tick duration below 1ns is not clamped to 1ns");
+}
+
+auto test_time_saturates() -> void {
+	wasi_clock::enable_deterministic(INT64_MAX, 1);
+	wasi_clock::advance_ticks(2);
+	expect(
+		clocks_are(static_cast<std::uint64_t>(INT64_MAX) * 2),
+		"largest time that fits"
+	);
+
+	wasi_clock::advance_ticks(1);
+	expect(clocks_are(UINT64_MAX), "time past the largest time");
+
+	wasi_clock::advance_ticks(INT64_MAX);
+	expect(clocks_are(UINT64_MAX), "time far past the largest time");
+}
+
+auto test_deterministic_random() -> void {
+	wasi_clock::enable_deterministic(1000, 42);
+	auto first = random_for(system_a, entity_a);
+
+	expect(first == random_for(system_a, entity_a), "same inputs differ");
+	expect(first != random_for(system_b, entity_a), "system ignored");
+	expect(first != random_for(system_a, entity_b), "entity ignored");
+	expect(first != random_for(system_a, entity_a, 2), "counter ignored");
+
+	auto counter = std::uint64_t{};
+	auto bytes = random_bytes{};
+	wasi_clock::random_get(system_a, entity_a, counter, bytes);
+	expect(counter == 2, "counter not advanced by the words handed out");
+	wasi_clock::random_get(system_a, entity_a, counter, bytes);
+	expect(
+		bytes == random_for(system_a, entity_a, 2),
+		"second call does not continue from the counter"
+	);
+
+	wasi_clock::advance_ticks(1);
+	expect(first != random_for(system_a, entity_a), "tick ignored");
+
+	wasi_clock::enable_deterministic(1000, 43);
+	expect(first != random_for(system_a, entity_a), "seed ignored");
+
+	wasi_clock::enable_deterministic(1000, 42);
+	expect(
+		first == random_for(system_a, entity_a),
+		"same seed after re-enabling gives different bytes"
+	);
+}
+
+auto test_disable() -> void {
+	wasi_clock::enable_deterministic(1000, 42);
+	wasi_clock::disable_deterministic();
+
+	auto time = std::uint64_t{};
+	expect(
+		wasi_clock::time_get(clockid::realtime, time) == wasi_errno::success &&
+			time > 0,
+		"realtime clock after disabling deterministic mode"
+	);
+
+	auto counter = std::uint64_t{};
+	auto bytes = random_bytes{};
+	wasi_clock::random_get(system_a, entity_a, counter, bytes);
+	expect(counter == 0, "OS randomness advanced the deterministic counter");
+}
+
+auto main() -> int {
+	test_deterministic_time();
+	test_time_saturates();
+	test_deterministic_random();
+	test_disable();
+
+	if(failures > 0) {
+		return 1;
+	}
+
+	std::cout << "Test complete!\n";
+	return 0;
+}
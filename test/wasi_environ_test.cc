@@ -0,0 +1,177 @@
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <wasm.h>
+#include "ecsact/si/wasmer/detail/instance_env.hh"
+#include "ecsact/si/wasmer/detail/wasi.hh"
+#include "ecsact/si/wasmer/detail/wasi_env_vars.hh"
+
+using ecsact::wasm::detail::instance_env;
+
+namespace env_vars = ecsact::wasm::detail::wasi::env_vars;
+
+/**
+ * Guest addresses used by the test. The buffer is deliberately unaligned.
+ */
+constexpr auto sizes_count_ptr = std::int32_t{16};
+constexpr auto sizes_buf_size_ptr = std::int32_t{20};
+constexpr auto environ_ptr = std::int32_t{64};
+constexpr auto environ_buf_ptr = std::int32_t{1001};
+constexpr auto sentinel = std::byte{0xAB};
+
+auto failures = 0;
+
+auto expect(bool condition, std::string_view what) -> void {
+	if(!condition) {
+		std::cerr << "[TEST FAILED]: " << what << std::endl;
+		failures += 1;
+	}
+}
+
+/**
+ * Calls the WASI import @p fn like a guest would
+ * @returns the errno result or `std::nullopt` if @p fn trapped
+ */
+auto call_import(
+	wasm_func_callback_with_env_t fn,
+	instance_env&                 env,
+	std::int32_t                  arg0,
+	std::int32_t                  arg1
+) -> std::optional<std::int32_t> {
+	wasm_val_t args_val[2] = {WASM_I32_VAL(arg0), WASM_I32_VAL(arg1)};
+	wasm_val_t results_val[1] = {WASM_INIT_VAL};
+	wasm_val_vec_t args = WASM_ARRAY_VEC(args_val);
+	wasm_val_vec_t results = WASM_ARRAY_VEC(results_val);
+
+	if(auto trap = fn(&env, &args, &results)) {
+		wasm_trap_delete(trap);
+		return std::nullopt;
+	}
+	return results_val[0].of.i32;
+}
+
+auto read_u32(const instance_env& env, std::int32_t guest_ptr)
+	-> std::uint32_t {
+	auto value = std::uint32_t{};
+	std::memcpy(&value, env.memory_data + guest_ptr, sizeof(value));
+	return value;
+}
+
+auto main() -> int {
+	auto engine = wasm_engine_new();
+	auto store = wasm_store_new(engine);
+	auto limits = wasm_limits_t{.min = 1, .max = 1};
+	auto memory_type = wasm_memorytype_new(&limits);
+	auto memory = wasm_memory_new(store, memory_type);
+	wasm_memorytype_delete(memory_type);
+
+	auto vars = std::vector<std::string>{
+		"A=1",
+		"LONGER_NAME=some value",
+		"EMPTY=",
+	};
+	env_vars::set_environment(vars);
+
+	auto env = instance_env{};
+	env.store = store;
+	env.memory = memory;
+	env.sync_memory();
+
+	auto expected_buf_size = std::size_t{};
+	for(auto& var : vars) {
+		expected_buf_size += var.size() + 1;
+	}
+	std::memset(env.memory_data, static_cast<int>(sentinel), 4096);
+
+	expect(
+		call_import(
+			ecsact_si_wasi_environ_sizes_get,
+			env,
+			sizes_count_ptr,
+			sizes_buf_size_ptr
+		) == 0,
+		"environ_sizes_get failed"
+	);
+	expect(
+		read_u32(env, sizes_count_ptr) == vars.size(),
+		"environ_sizes_get variable count"
+	);
+	expect(
+		read_u32(env, sizes_buf_size_ptr) == expected_buf_size,
+		"environ_sizes_get buffer size"
+	);
+
+	// Instances keep the environment they first read
+	env_vars::set_environment({"CHANGED=1"});
+
+	expect(
+		call_import(
+			ecsact_si_wasi_environ_get,
+			env,
+			environ_ptr,
+			environ_buf_ptr
+		) == 0,
+		"environ_get failed"
+	);
+
+	auto expected_buf = std::string{};
+	for(auto i = std::size_t{}; vars.size() > i; ++i) {
+		auto var_ptr = read_u32(env, environ_ptr + 4 * static_cast<int>(i));
+		expect(
+			var_ptr == environ_buf_ptr + expected_buf.size(),
+			"environ_get pointer does not point at its variable"
+		);
+		expect(
+			var_ptr < env.memory_data_size &&
+				std::string_view{
+					reinterpret_cast<const char*>(env.memory_data + var_ptr)
+				} == vars[i],
+			"environ_get variable content"
+		);
+
+		expected_buf += vars[i];
+		expected_buf += '\0';
+	}
+
+	auto environ_buf = env.memory_data + environ_buf_ptr;
+	expect(
+		std::memcmp(environ_buf, expected_buf.data(), expected_buf.size()) == 0,
+		"environ_get buffer is not null terminated strings back to back"
+	);
+	expect(
+		environ_buf[expected_buf.size()] == sentinel,
+		"environ_get wrote past the end of the buffer"
+	);
+	expect(
+		env.memory_data[environ_ptr + 4 * vars.size()] == sentinel,
+		"environ_get wrote past the end of the pointer array"
+	);
+
+	auto near_end = static_cast<std::int32_t>(env.memory_data_size - 4);
+	auto environ_get = [&](std::int32_t arg0, std::int32_t arg1) {
+		return call_import(ecsact_si_wasi_environ_get, env, arg0, arg1);
+	};
+	expect(
+		!environ_get(environ_ptr, near_end),
+		"environ_get buffer out of bounds did not trap"
+	);
+	expect(
+		!environ_get(near_end, environ_buf_ptr),
+		"environ_get pointer array out of bounds did not trap"
+	);
+
+	wasm_memory_delete(memory);
+	wasm_store_delete(store);
+	wasm_engine_delete(engine);
+
+	if(failures > 0) {
+		return 1;
+	}
+
+	std::cout << "Test complete!\n";
+	return 0;
+}
@@ -0,0 +1,249 @@
+#include <cstdint>
+#include <cstring>
+#include <cstdlib>
+#include <iostream>
+#include <filesystem>
+#include <fstream>
+#include <span>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+#include "ecsact/si/wasmer/detail/wasi_fs.hh"
+
+namespace fs = std::filesystem;
+namespace wasi_fs = ecsact::wasm::detail::wasi::fs;
+
+using wasi_errno = ecsact_si_wasi_errno;
+
+auto failures = 0;
+
+auto expect(bool condition, std::string_view what) -> void {
+	if(!condition) {
+		std::cerr << "[TEST FAILED]: " << what << std::endl;
+		failures += 1;
+	}
+}
+
+auto write_file(const fs::path& p, std::string_view content) -> void {
+	auto file = std::ofstream{p, std::ios::binary};
+	file.write(content.data(), static_cast<std::streamsize>(content.size()));
+}
+
+auto as_string(std::span<const std::byte> bytes) -> std::string {
+	auto chars = reinterpret_cast<const char*>(bytes.data());
+	return std::string{chars, bytes.size()};
+}
+
+/**
+ * Names of the complete entries in a `readdir` result and the cookie to
+ * continue from
+ */
+struct readdir_page {
+	std::vector<std::string> names;
+	std::uint64_t            next_cookie = 0;
+};
+
+auto parse_dirents(std::span<const std::byte> buf) -> readdir_page {
+	auto page = readdir_page{};
+	auto offset = std::size_t{};
+	while(buf.size() - offset >= sizeof(ecsact_si_wasi_dirent_t)) {
+		auto dirent = ecsact_si_wasi_dirent_t{};
+		std::memcpy(&dirent, buf.data() + offset, sizeof(dirent));
+		offset += sizeof(dirent);
+
+		// Truncated entries are read again from their cookie on the next call
+		if(buf.size() - offset < dirent.d_namlen) {
+			break;
+		}
+
+		page.names.push_back(as_string(buf.subspan(offset, dirent.d_namlen)));
+		page.next_cookie = dirent.d_next;
+		offset += dirent.d_namlen;
+	}
+	return page;
+}
+
+/**
+ * Creates a preopen tree in @p root with a symlink to @p outside that guests
+ * must not be able to follow.
+ * @returns `false` if symlinks could not be created on this platform
+ */
+auto create_test_tree(const fs::path& root, const fs::path& outside) -> bool {
+	fs::create_directories(root / "sub");
+	fs::create_directories(outside);
+	write_file(root / "a.txt", "abc\n");
+	write_file(root / "sub" / "b.txt", "xyz\n");
+	for(auto i = 0; 8 > i; ++i) {
+		write_file(root / ("file_" + std::to_string(i) + ".txt"), "");
+	}
+	write_file(outside / "secret.txt", "secret\n");
+
+	auto ec = std::error_code{};
+	fs::create_symlink(outside / "secret.txt", root / "escape_file", ec);
+	if(ec) {
+		return false;
+	}
+	fs::create_directory_symlink(outside, root / "escape_dir", ec);
+	return !ec;
+}
+
+/**
+ * Opens @p path for reading
+ * @returns `true` if the open succeeded
+ */
+auto can_open(
+	wasi_fs::fd_table& table,
+	std::int32_t       dir_fd,
+	std::string_view   path
+) -> bool {
+	auto fd = std::int32_t{-1};
+	auto result = wasi_fs::path_open(table, dir_fd, path, {}, false, fd);
+	return result == wasi_errno::success;
+}
+
+auto test_path_open_escapes(std::int32_t preopen_fd, bool has_symlinks)
+	-> void {
+	auto table = wasi_fs::fd_table{};
+
+	expect(can_open(table, preopen_fd, "sub/../a.txt"), "open sub/../a.txt");
+	expect(
+		!can_open(table, preopen_fd, "../outside/secret.txt"),
+		"path_open ../ escaped the preopen"
+	);
+	expect(
+		!can_open(table, preopen_fd, "sub/../../outside/secret.txt"),
+		"path_open sub/../../ escaped the preopen"
+	);
+	expect(
+		!can_open(table, preopen_fd, "/etc/passwd"),
+		"path_open absolute path escaped the preopen"
+	);
+
+	auto dir_fd = std::int32_t{-1};
+	auto sub_result = wasi_fs::path_open(
+		table,
+		preopen_fd,
+		"sub",
+		ecsact_si_wasi_oflags::directory,
+		false,
+		dir_fd
+	);
+	expect(sub_result == wasi_errno::success, "path_open sub directory");
+	if(sub_result == wasi_errno::success) {
+		expect(
+			can_open(table, dir_fd, "../a.txt"),
+			"path_open ../ inside the preopen from a subdirectory"
+		);
+		expect(
+			!can_open(table, dir_fd, "../../outside/secret.txt"),
+			"path_open ../../ escaped the preopen from a subdirectory"
+		);
+	}
+
+	if(!has_symlinks) {
+		std::cout << "Symlinks not supported, skipping symlink escapes\n";
+		return;
+	}
+
+	expect(
+		!can_open(table, preopen_fd, "escape_file"),
+		"path_open followed a file symlink out of the preopen"
+	);
+	expect(
+		!can_open(table, preopen_fd, "escape_dir/secret.txt"),
+		"path_open followed a directory symlink out of the preopen"
+	);
+}
+
+auto test_readdir_paging(std::int32_t preopen_fd) -> void {
+	auto table = wasi_fs::fd_table{};
+	auto used = std::uint32_t{};
+
+	auto full_buf = std::vector<std::byte>(4096);
+	auto full_result = wasi_fs::readdir(table, preopen_fd, full_buf, 0, used);
+	expect(full_result == wasi_errno::success, "readdir full listing");
+	expect(used < full_buf.size(), "readdir full listing did not fit");
+	auto full = parse_dirents(std::span{full_buf}.first(used)).names;
+
+	// Symlinks out of the preopen are left out
+	auto expected = std::vector<std::string>{"a.txt"};
+	for(auto i = 0; 8 > i; ++i) {
+		expected.push_back("file_" + std::to_string(i) + ".txt");
+	}
+	expected.push_back("sub");
+	expect(full == expected, "readdir full listing has unexpected entries");
+
+	// Small enough that every page ends with a truncated entry
+	auto page_buf = std::vector<std::byte>(sizeof(ecsact_si_wasi_dirent_t) * 3);
+	auto paged = std::vector<std::string>{};
+	auto cookie = std::uint64_t{};
+	for(;;) {
+		auto result =
+			wasi_fs::readdir(table, preopen_fd, page_buf, cookie, used);
+		expect(result == wasi_errno::success, "readdir page");
+		if(result != wasi_errno::success) {
+			return;
+		}
+
+		auto page = parse_dirents(std::span{page_buf}.first(used));
+		paged.insert(paged.end(), page.names.begin(), page.names.end());
+
+		// A short result means the end of the directory was reached
+		if(used < page_buf.size()) {
+			break;
+		}
+		if(page.names.empty()) {
+			expect(false, "readdir page fit no complete entry");
+			return;
+		}
+		cookie = page.next_cookie;
+	}
+
+	expect(paged == full, "readdir pages differ from the full listing");
+
+	expect(
+		wasi_fs::readdir(table, preopen_fd, full_buf, full.size(), used) ==
+				wasi_errno::success &&
+			used == 0,
+		"readdir with a cookie past the last entry"
+	);
+}
+
+auto main() -> int {
+	auto tmp_dir = std::getenv("TEST_TMPDIR");
+	auto test_dir = (tmp_dir ? fs::path{tmp_dir} : fs::temp_directory_path()) /
+		"ecsact_si_wasmer_wasi_fs_test";
+	fs::remove_all(test_dir);
+
+	auto root = test_dir / "root";
+	auto has_symlinks = create_test_tree(root, test_dir / "outside");
+
+	for(auto build_index : {true, false}) {
+		auto virtual_path = build_index ? "indexed" : "unindexed";
+		std::cout << "Testing " << virtual_path << " preopen\n";
+
+		auto preopen_fd = wasi_fs::allow_dir_read_access(
+			root.string(),
+			virtual_path,
+			build_index
+		);
+		if(preopen_fd == -1) {
+			std::cerr //
+				<< "[TEST FAILED]: allow_dir_read_access " << root << std::endl;
+			return 1;
+		}
+
+		test_path_open_escapes(preopen_fd, has_symlinks);
+		test_readdir_paging(preopen_fd);
+	}
+
+	fs::remove_all(test_dir);
+
+	if(failures > 0) {
+		return 1;
+	}
+
+	std::cout << "Test complete!\n";
+	return 0;
+}
@@ -0,0 +1,132 @@
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "ecsact/si/wasmer/detail/wasi_fs.hh"
+
+namespace wasi_fs = ecsact::wasm::detail::wasi::fs;
+
+using wasi_errno = ecsact_si_wasi_errno;
+using whence = ecsact_si_wasi_whence;
+
+constexpr auto file_content = std::string_view{"abc\n"};
+
+auto failures = 0;
+
+auto expect(bool condition, std::string_view what) -> void {
+	if(!condition) {
+		std::cerr << "[TEST FAILED]: " << what << std::endl;
+		failures += 1;
+	}
+}
+
+auto as_string(std::span<const std::byte> bytes) -> std::string {
+	auto chars = reinterpret_cast<const char*>(bytes.data());
+	return std::string{chars, bytes.size()};
+}
+
+auto test_seek(wasi_fs::fd_table& table, std::int32_t fd) -> void {
+	auto buf = std::vector<std::byte>(16);
+	auto new_offset = std::uint64_t{};
+	auto seek = [&](std::int64_t offset, whence from) -> wasi_errno {
+		return wasi_fs::seek(table, fd, offset, from, new_offset);
+	};
+
+	expect(
+		seek(-1, whence::set) == wasi_errno::inval,
+		"seek before the start of the file"
+	);
+	expect(
+		seek(INT64_MIN, whence::end) == wasi_errno::inval,
+		"seek INT64_MIN from the end"
+	);
+	expect(wasi_fs::tell(table, fd) == 0, "failed seek moved the position");
+
+	expect(
+		seek(2, whence::cur) == wasi_errno::success && new_offset == 2,
+		"seek forward from the current position"
+	);
+	expect(
+		seek(-3, whence::cur) == wasi_errno::inval,
+		"seek back past the start from the current position"
+	);
+	expect(
+		seek(INT64_MAX, whence::cur) == wasi_errno::inval,
+		"seek overflowing the position"
+	);
+	expect(wasi_fs::tell(table, fd) == 2, "failed seek moved the position");
+
+	expect(
+		seek(-1, whence::end) == wasi_errno::success && new_offset == 3,
+		"seek back from the end"
+	);
+	expect(
+		wasi_fs::read(table, fd, buf) == 1 && as_string({buf.data(), 1}) == "\n",
+		"read after seeking from the end"
+	);
+
+	expect(
+		seek(100, whence::set) == wasi_errno::success && new_offset == 100,
+		"seek past the end of the file"
+	);
+	expect(wasi_fs::read(table, fd, buf) == 0, "read past the end of the file");
+	expect(wasi_fs::tell(table, fd) == 100, "read past the end moved position");
+}
+
+auto test_pread(wasi_fs::fd_table& table, std::int32_t fd) -> void {
+	auto buf = std::vector<std::byte>(16);
+	auto position = wasi_fs::tell(table, fd);
+
+	expect(
+		wasi_fs::pread(table, fd, buf, 2) == 2 &&
+			as_string({buf.data(), 2}) == "c\n",
+		"pread inside the file"
+	);
+	expect(wasi_fs::tell(table, fd) == position, "pread moved the position");
+	expect(wasi_fs::pread(table, fd, buf, 4) == 0, "pread at the end");
+	expect(wasi_fs::pread(table, fd, buf, 1000) == 0, "pread past the end");
+	expect(
+		wasi_fs::pread(table, fd, buf, UINT64_MAX) == 0,
+		"pread at the largest offset"
+	);
+}
+
+auto test_unknown_descriptor(wasi_fs::fd_table& table, std::int32_t fd)
+	-> void {
+	auto buf = std::vector<std::byte>(16);
+	auto new_offset = std::uint64_t{};
+
+	expect(
+		wasi_fs::seek(table, fd, 0, whence::set, new_offset) == wasi_errno::badf,
+		"seek on an unknown descriptor"
+	);
+	expect(!wasi_fs::tell(table, fd), "tell on an unknown descriptor");
+	expect(
+		!wasi_fs::pread(table, fd, buf, 0).has_value(),
+		"pread on an unknown descriptor"
+	);
+}
+
+auto main() -> int {
+	auto data = std::vector<std::byte>(file_content.size());
+	for(auto i = std::size_t{}; file_content.size() > i; ++i) {
+		data[i] = static_cast<std::byte>(file_content[i]);
+	}
+
+	auto fd = wasi_fs::allow_file_read_buffer("seek.txt", std::move(data));
+	auto table = wasi_fs::fd_table{};
+
+	test_seek(table, fd);
+	test_pread(table, fd);
+	test_unknown_descriptor(table, fd + 1000);
+
+	if(failures > 0) {
+		return 1;
+	}
+
+	std::cout << "Test complete!\n";
+	return 0;
+}
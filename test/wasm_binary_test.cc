@@ -0,0 +1,244 @@
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <iostream>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+#include "ecsact/si/wasmer/detail/wasm_binary.hh"
+
+using ecsact::wasm::detail::find_empty_exported_funcs;
+
+using bytes = std::vector<std::byte>;
+using names = std::unordered_set<std::string>;
+
+constexpr auto import_section_id = std::uint8_t{2};
+constexpr auto export_section_id = std::uint8_t{7};
+constexpr auto code_section_id = std::uint8_t{10};
+
+constexpr auto extern_kind_func = std::uint8_t{0};
+constexpr auto extern_kind_memory = std::uint8_t{2};
+
+constexpr auto opcode_nop = std::uint8_t{0x01};
+constexpr auto opcode_end = std::uint8_t{0x0B};
+constexpr auto valtype_i32 = std::uint8_t{0x7F};
+
+auto failures = 0;
+
+auto expect(bool condition, std::string_view what) -> void {
+	if(!condition) {
+		std::cerr << "[TEST FAILED]: " << what << std::endl;
+		failures += 1;
+	}
+}
+
+auto append(bytes& out, std::initializer_list<std::uint8_t> values) -> void {
+	for(auto value : values) {
+		out.push_back(static_cast<std::byte>(value));
+	}
+}
+
+auto append(bytes& out, const bytes& other) -> void {
+	out.insert(out.end(), other.begin(), other.end());
+}
+
+auto append_u32(bytes& out, std::uint32_t value) -> void {
+	do {
+		auto b = static_cast<std::uint8_t>(value & 0x7F);
+		value >>= 7;
+		append(out, {static_cast<std::uint8_t>(value ? b | 0x80 : b)});
+	} while(value);
+}
+
+auto append_name(bytes& out, std::string_view name) -> void {
+	append_u32(out, static_cast<std::uint32_t>(name.size()));
+	for(auto c : name) {
+		out.push_back(static_cast<std::byte>(c));
+	}
+}
+
+auto append_section(bytes& out, std::uint8_t id, const bytes& contents)
+	-> void {
+	append(out, {id});
+	append_u32(out, static_cast<std::uint32_t>(contents.size()));
+	append(out, contents);
+}
+
+auto module_header() -> bytes {
+	auto out = bytes{};
+	append(out, {0x00, 0x61, 0x73, 0x6D, 0x01, 0x00, 0x00, 0x00});
+	return out;
+}
+
+auto import_section(std::uint8_t memory_kind) -> bytes {
+	auto section = bytes{};
+	append_u32(section, 2);
+	append_name(section, "env");
+	append_name(section, "imported");
+	append(section, {extern_kind_func});
+	append_u32(section, 0);
+	append_name(section, "env");
+	append_name(section, "memory");
+	append(section, {memory_kind, 0x00});
+	append_u32(section, 1);
+	return section;
+}
+
+/**
+ * Exports the imported function, three defined functions and the memory
+ */
+auto export_section() -> bytes {
+	auto section = bytes{};
+	append_u32(section, 5);
+	auto exports = {"imported", "empty", "busy", "empty_locals"};
+	auto index = std::uint32_t{};
+	for(auto name : exports) {
+		append_name(section, name);
+		append(section, {extern_kind_func});
+		append_u32(section, index++);
+	}
+	append_name(section, "memory");
+	append(section, {extern_kind_memory});
+	append_u32(section, 0);
+	return section;
+}
+
+auto code_section(const std::vector<bytes>& bodies) -> bytes {
+	auto section = bytes{};
+	append_u32(section, static_cast<std::uint32_t>(bodies.size()));
+	for(auto& body : bodies) {
+		append_u32(section, static_cast<std::uint32_t>(body.size()));
+		append(section, body);
+	}
+	return section;
+}
+
+auto func_bodies() -> std::vector<bytes> {
+	auto empty = bytes{};
+	append(empty, {0x00, opcode_end});
+
+	auto busy = bytes{};
+	append(busy, {0x00, opcode_nop, opcode_end});
+
+	auto empty_locals = bytes{};
+	append(empty_locals, {0x01, 0x02, valtype_i32, opcode_end});
+
+	return {empty, busy, empty_locals};
+}
+
+auto test_module(
+	std::uint8_t              memory_import_kind = extern_kind_memory,
+	const std::vector<bytes>& bodies = func_bodies()
+) -> bytes {
+	auto module = module_header();
+	append_section(module, import_section_id, import_section(memory_import_kind));
+	append_section(module, export_section_id, export_section());
+	append_section(module, code_section_id, code_section(bodies));
+	return module;
+}
+
+auto test_well_formed() -> void {
+	expect(
+		find_empty_exported_funcs(test_module()) == names{"empty", "empty_locals"},
+		"well formed module"
+	);
+
+	auto bad_magic = test_module();
+	bad_magic[1] = std::byte{'X'};
+	expect(find_empty_exported_funcs(bad_magic).empty(), "bad magic");
+}
+
+auto test_truncated_sections() -> void {
+	auto module = test_module();
+
+	// Every section is needed to find an empty function so no strict prefix
+	// has any
+	for(auto size = std::size_t{}; module.size() > size; ++size) {
+		auto truncated = std::span{module}.first(size);
+		if(!find_empty_exported_funcs(truncated).empty()) {
+			expect(false, "truncated module at " + std::to_string(size));
+		}
+	}
+
+	auto oversized_section = module_header();
+	append(oversized_section, {code_section_id});
+	append_u32(oversized_section, 100);
+	append_u32(oversized_section, 1);
+	expect(
+		find_empty_exported_funcs(oversized_section).empty(),
+		"section size past the end of the module"
+	);
+
+	auto oversized_body = module_header();
+	append_section(oversized_body, export_section_id, export_section());
+	append(oversized_body, {code_section_id});
+	append_u32(oversized_body, 3);
+	append_u32(oversized_body, 1);
+	append_u32(oversized_body, 100);
+	append(oversized_body, {opcode_end});
+	expect(
+		find_empty_exported_funcs(oversized_body).empty(),
+		"function body size past the end of the code section"
+	);
+
+	auto huge_count = module_header();
+	auto huge_count_section = bytes{};
+	append_u32(huge_count_section, UINT32_MAX);
+	append_section(huge_count, code_section_id, huge_count_section);
+	expect(
+		find_empty_exported_funcs(huge_count).empty(),
+		"code section declaring more bodies than it has"
+	);
+}
+
+auto test_unknown_import_kind() -> void {
+	expect(
+		find_empty_exported_funcs(test_module(0x7F)).empty(),
+		"unknown import kind"
+	);
+}
+
+auto test_empty_bodies() -> void {
+	auto bodies = func_bodies();
+
+	// Missing both the locals count and the final `end`
+	bodies[0] = {};
+	expect(
+		find_empty_exported_funcs(test_module(extern_kind_memory, bodies)) ==
+			names{"empty_locals"},
+		"zero length function body"
+	);
+
+	// Locals count without the final `end`
+	bodies[0] = {std::byte{0x00}};
+	expect(
+		find_empty_exported_funcs(test_module(extern_kind_memory, bodies)) ==
+			names{"empty_locals"},
+		"function body without end"
+	);
+
+	// Exports without a body are not empty functions
+	bodies.resize(1);
+	bodies[0] = func_bodies()[0];
+	expect(
+		find_empty_exported_funcs(test_module(extern_kind_memory, bodies)) ==
+			names{"empty"},
+		"exports past the last function body"
+	);
+}
+
+auto main() -> int {
+	test_well_formed();
+	test_truncated_sections();
+	test_unknown_import_kind();
+	test_empty_bodies();
+
+	if(failures > 0) {
+		return 1;
+	}
+
+	std::cout << "Test complete!\n";
+	return 0;
+}
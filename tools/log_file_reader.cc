@@ -0,0 +1,168 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include "ecsact/si/wasmer/log_file.h"
+#include "ecsact/si/wasmer/detail/line_assembler.hh"
+
+using ecsact::wasm::detail::line_assembler;
+
+/**
+ * Prints the records of a binary log file written by
+ * `ecsact_si_wasmer_open_log_file` as text lines.
+ *
+ * Usage: log_file_reader <log-file>
+ */
+
+namespace {
+auto level_name(int32_t log_level) -> std::string_view {
+	switch(log_level) {
+		case ECSACT_SI_WASM_LOG_LEVEL_INFO:
+			return "INFO";
+		case ECSACT_SI_WASM_LOG_LEVEL_WARNING:
+			return "WARNING";
+		case ECSACT_SI_WASM_LOG_LEVEL_ERROR:
+			return "ERROR";
+	}
+	return "UNKNOWN";
+}
+
+/**
+ * @returns `true` if everything from @p offset to the end of the file is the
+ *          unwritten space a dropped write reserved
+ */
+auto is_dropped_tail(
+	const ecsact_si_wasmer_log_file_header& header,
+	const std::vector<char>&                data,
+	uint64_t                                offset
+) -> bool {
+	auto records_capacity = header.capacity - sizeof(header);
+	if(header.dropped_count == 0 || header.write_offset <= records_capacity) {
+		return false;
+	}
+
+	auto tail = data.begin() + static_cast<std::ptrdiff_t>(offset);
+	return std::all_of(tail, data.end(), [](char c) { return c == 0; });
+}
+
+auto print_line(
+	const ecsact_si_wasmer_log_file_record& record,
+	std::string_view                        line
+) -> void {
+	std::cout //
+		<< record.timestamp_ns << " " << level_name(record.log_level)
+		<< " system=" << record.system_id << " entity=" << record.entity
+		<< " instance=" << record.instance_index
+		<< " thread=" << record.thread_id << ": " << line << "\n";
+}
+} // namespace
+
+auto main(int argc, char* argv[]) -> int {
+	if(argc != 2) {
+		std::cerr << "Usage: " << argv[0] << " <log-file>\n";
+		return 1;
+	}
+
+	auto file = std::ifstream{argv[1], std::ios::binary};
+	if(!file) {
+		std::cerr << "Cannot open " << argv[1] << "\n";
+		return 1;
+	}
+
+	auto data = std::vector<char>{
+		std::istreambuf_iterator<char>{file},
+		std::istreambuf_iterator<char>{},
+	};
+
+	auto header = ecsact_si_wasmer_log_file_header{};
+	if(data.size() < sizeof(header)) {
+		std::cerr << argv[1] << " is not a log file\n";
+		return 1;
+	}
+	std::memcpy(&header, data.data(), sizeof(header));
+	if(std::memcmp(
+			 header.magic,
+			 ECSACT_SI_WASMER_LOG_FILE_MAGIC,
+			 sizeof(header.magic)
+		 ) != 0) {
+		std::cerr << argv[1] << " is not a log file\n";
+		return 1;
+	}
+
+	auto end = std::min<uint64_t>(
+		sizeof(header) + header.write_offset,
+		data.size()
+	);
+
+	struct line_source {
+		line_assembler assembler;
+
+		/**
+		 * Record the unfinished line started in
+		 */
+		ecsact_si_wasmer_log_file_record line_record;
+	};
+
+	// Records are writes, so lines are assembled per thread and level the same
+	// way the in-memory log consumers do it. Lines are attributed to the write
+	// that started them.
+	auto sources = std::map<std::pair<uint64_t, int32_t>, line_source>{};
+
+	auto offset = static_cast<uint64_t>(sizeof(header));
+	while(offset + sizeof(ecsact_si_wasmer_log_file_record) <= end) {
+		auto record = ecsact_si_wasmer_log_file_record{};
+		std::memcpy(&record, data.data() + offset, sizeof(record));
+
+		if(record.record_size == 0) {
+			// The write that overflowed the file reserved the rest of it and left
+			// it zeroed, that is not an incomplete record
+			if(!is_dropped_tail(header, data, offset)) {
+				std::cerr //
+					<< "Stopped at incomplete record at offset " << offset << "\n";
+			}
+			break;
+		}
+
+		if(offset + record.record_size > end ||
+			 sizeof(record) + record.message_length > record.record_size) {
+			std::cerr << "Stopped at corrupt record at offset " << offset << "\n";
+			break;
+		}
+
+		auto message = std::string_view{
+			data.data() + offset + sizeof(record),
+			record.message_length,
+		};
+
+		auto& source = sources[{record.thread_id, record.log_level}];
+		if(!source.assembler.has_tail()) {
+			source.line_record = record;
+		}
+		source.assembler.feed(message, [&](std::string_view line) {
+			print_line(source.line_record, line);
+			source.line_record = record;
+		});
+
+		offset += record.record_size;
+	}
+
+	for(auto& [_, source] : sources) {
+		source.assembler.finish([&](std::string_view line) {
+			print_line(source.line_record, line);
+		});
+	}
+
+	if(header.dropped_count > 0) {
+		std::cerr << header.dropped_count
+							<< " write(s) dropped because the log file was full\n";
+	}
+
+	return 0;
+}